@@ -34,28 +34,43 @@ SOURCES += src/main.cpp \
     src/core/ActionsManager.cpp \
     src/core/Addon.cpp \
     src/core/AddonsManager.cpp \
+    src/core/AddressCompletionIndex.cpp \
     src/core/AddressCompletionModel.cpp \
+    src/core/AddressCompletionWorker.cpp \
     src/core/Application.cpp \
+    src/core/BookmarksFilterModel.cpp \
     src/core/BookmarksImporter.cpp \
     src/core/BookmarksManager.cpp \
     src/core/BookmarksModel.cpp \
+    src/core/BookmarksStore.cpp \
     src/core/ContentBlockingManager.cpp \
     src/core/ContentBlockingProfile.cpp \
     src/core/Console.cpp \
     src/core/CookieJar.cpp \
+    src/core/CookieJarWorker.cpp \
+    src/core/CookiesStore.cpp \
+    src/core/FaviconsCache.cpp \
     src/core/FileSystemCompleterModel.cpp \
     src/core/GesturesManager.cpp \
     src/core/HistoryManager.cpp \
+    src/core/HttpArchive.cpp \
     src/core/Importer.cpp \
     src/core/InputInterpreter.cpp \
     src/core/LocalListingNetworkReply.cpp \
     src/core/NetworkManager.cpp \
     src/core/NetworkManagerFactory.cpp \
     src/core/NetworkAutomaticProxy.cpp \
+    src/core/NetworkAutomaticProxyWorker.cpp \
     src/core/NetworkCache.cpp \
+    src/core/NetworkCacheDevice.cpp \
+    src/core/NetworkCacheIndex.cpp \
+    src/core/NetworkCacheModel.cpp \
+    src/core/NetworkCacheWorker.cpp \
     src/core/NetworkProxyFactory.cpp \
     src/core/Notification.cpp \
+    src/core/PageLoadBenchmark.cpp \
     src/core/PlatformIntegration.cpp \
+    src/core/ReplayNetworkReply.cpp \
     src/core/SearchesManager.cpp \
     src/core/SearchSuggester.cpp \
     src/core/SessionsManager.cpp \
@@ -102,6 +117,8 @@ SOURCES += src/main.cpp \
     src/ui/TextLabelWidget.cpp \
     src/ui/TrayIcon.cpp \
     src/ui/UserAgentsManagerDialog.cpp \
+    src/ui/WaterfallDelegate.cpp \
+    src/ui/WebsiteInformationDialog.cpp \
     src/ui/WebsitePreferencesDialog.cpp \
     src/ui/WebWidget.cpp \
     src/ui/Window.cpp \
@@ -129,6 +146,7 @@ SOURCES += src/main.cpp \
     src/modules/windows/configuration/ConfigurationContentsWidget.cpp \
     src/modules/windows/cookies/CookiesContentsWidget.cpp \
     src/modules/windows/history/HistoryContentsWidget.cpp \
+    src/modules/windows/network/NetworkStatisticsContentsWidget.cpp \
     src/modules/windows/transfers/ProgressBarDelegate.cpp \
     src/modules/windows/transfers/TransfersContentsWidget.cpp \
     src/modules/windows/web/ImagePropertiesDialog.cpp \
@@ -144,28 +162,43 @@ HEADERS += src/core/Action.h \
     src/core/ActionsManager.h \
     src/core/Addon.h \
     src/core/AddonsManager.h \
+    src/core/AddressCompletionIndex.h \
     src/core/AddressCompletionModel.h \
+    src/core/AddressCompletionWorker.h \
     src/core/Application.h \
+    src/core/BookmarksFilterModel.h \
     src/core/BookmarksImporter.h \
     src/core/BookmarksManager.h \
     src/core/BookmarksModel.h \
+    src/core/BookmarksStore.h \
     src/core/ContentBlockingManager.h \
     src/core/ContentBlockingProfile.h \
     src/core/Console.h \
     src/core/CookieJar.h \
+    src/core/CookieJarWorker.h \
+    src/core/CookiesStore.h \
+    src/core/FaviconsCache.h \
     src/core/FileSystemCompleterModel.h \
     src/core/GesturesManager.h \
     src/core/HistoryManager.h \
+    src/core/HttpArchive.h \
     src/core/Importer.h \
     src/core/InputInterpreter.h \
     src/core/LocalListingNetworkReply.h \
     src/core/NetworkAutomaticProxy.h \
+    src/core/NetworkAutomaticProxyWorker.h \
     src/core/NetworkCache.h \
+    src/core/NetworkCacheDevice.h \
+    src/core/NetworkCacheIndex.h \
+    src/core/NetworkCacheModel.h \
+    src/core/NetworkCacheWorker.h \
     src/core/NetworkManager.h \
     src/core/NetworkManagerFactory.h \
     src/core/NetworkProxyFactory.h \
     src/core/Notification.h \
+    src/core/PageLoadBenchmark.h \
     src/core/PlatformIntegration.h \
+    src/core/ReplayNetworkReply.h \
     src/core/SearchesManager.h \
     src/core/SearchSuggester.h \
     src/core/SessionsManager.h \
@@ -212,6 +245,8 @@ HEADERS += src/core/Action.h \
     src/ui/TextLabelWidget.h \
     src/ui/TrayIcon.h \
     src/ui/UserAgentsManagerDialog.h \
+    src/ui/WaterfallDelegate.h \
+    src/ui/WebsiteInformationDialog.h \
     src/ui/WebsitePreferencesDialog.h \
     src/ui/WebWidget.h \
     src/ui/Window.h \
@@ -239,6 +274,7 @@ HEADERS += src/core/Action.h \
     src/modules/windows/configuration/ConfigurationContentsWidget.h \
     src/modules/windows/cookies/CookiesContentsWidget.h \
     src/modules/windows/history/HistoryContentsWidget.h \
+    src/modules/windows/network/NetworkStatisticsContentsWidget.h \
     src/modules/windows/transfers/ProgressBarDelegate.h \
     src/modules/windows/transfers/TransfersContentsWidget.h \
     src/modules/windows/web/ImagePropertiesDialog.h \
@@ -268,6 +304,7 @@ FORMS += src/ui/AuthenticationDialog.ui \
     src/ui/SidebarWidget.ui \
     src/ui/StartupDialog.ui \
     src/ui/UserAgentsManagerDialog.ui \
+    src/ui/WebsiteInformationDialog.ui \
     src/ui/WebsitePreferencesDialog.ui \
     src/ui/preferences/AcceptLanguageDialog.ui \
     src/ui/preferences/ContentBlockingDialog.ui \
@@ -278,6 +315,7 @@ FORMS += src/ui/AuthenticationDialog.ui \
     src/modules/windows/configuration/ConfigurationContentsWidget.ui \
     src/modules/windows/cookies/CookiesContentsWidget.ui \
     src/modules/windows/history/HistoryContentsWidget.ui \
+    src/modules/windows/network/NetworkStatisticsContentsWidget.ui \
     src/modules/windows/transfers/TransfersContentsWidget.ui \
     src/modules/windows/web/ImagePropertiesDialog.ui \
     src/modules/windows/web/PermissionBarWidget.ui \
@@ -209,6 +209,7 @@ bool Action::isLocal(int identifier)
 		case Action::InspectPageAction:
 		case Action::InspectElementAction:
 		case Action::WebsitePreferencesAction:
+		case Action::WebsiteInformationAction:
 		case Action::QuickPreferencesAction:
 		case Action::ResetQuickPreferencesAction:
 			return true;
@@ -168,6 +168,7 @@ public:
 		TransfersAction,
 		PreferencesAction,
 		WebsitePreferencesAction,
+		WebsiteInformationAction,
 		QuickPreferencesAction,
 		ResetQuickPreferencesAction,
 		SwitchApplicationLanguageAction,
@@ -198,6 +198,7 @@ ActionsManagerHelper::ActionsManagerHelper(QObject *parent) : QObject(parent),
 	registerAction(Action::TransfersAction, QT_TRANSLATE_NOOP("actions", "Transfers..."));
 	registerAction(Action::PreferencesAction, QT_TRANSLATE_NOOP("actions", "Preferences..."));
 	registerAction(Action::WebsitePreferencesAction, QT_TRANSLATE_NOOP("actions", "Website Preferences..."));
+	registerAction(Action::WebsiteInformationAction, QT_TRANSLATE_NOOP("actions", "Website Information..."));
 	registerAction(Action::QuickPreferencesAction, QT_TRANSLATE_NOOP("actions", "Quick Preferences"));
 	registerAction(Action::ResetQuickPreferencesAction, QT_TRANSLATE_NOOP("actions", "Reset Options"));
 	registerAction(Action::SwitchApplicationLanguageAction, QT_TRANSLATE_NOOP("actions", "Switch Application Language..."), QString(), Utils::getIcon(QLatin1String("preferences-desktop-locale")));
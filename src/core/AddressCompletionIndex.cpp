@@ -0,0 +1,581 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "AddressCompletionIndex.h"
+
+#include <QtCore/QSet>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+AddressCompletionIndex::KeyComparator::KeyComparator(const QVector<Entry> *entries) : m_entries(entries)
+{
+}
+
+bool AddressCompletionIndex::KeyComparator::operator()(const Key &first, const Key &second) const
+{
+	return (getKeyText(m_entries->at(first.entry), first) < getKeyText(m_entries->at(second.entry), second));
+}
+
+bool AddressCompletionIndex::KeyComparator::operator()(const Key &key, const QString &text) const
+{
+	return (getKeyText(m_entries->at(key.entry), key) < QStringRef(&text));
+}
+
+bool AddressCompletionIndex::KeyComparator::operator()(const QString &text, const Key &key) const
+{
+	return (QStringRef(&text) < getKeyText(m_entries->at(key.entry), key));
+}
+
+AddressCompletionIndex::AddressCompletionIndex() : m_needsSorting(false)
+{
+}
+
+void AddressCompletionIndex::applyChange(const Change &change)
+{
+	if (change.isRemoval)
+	{
+		removeEntry(change.url, change.source);
+	}
+	else if (change.isVisit)
+	{
+		addVisits(change.url, change.title, change.source, change.visits, change.lastVisit);
+	}
+	else
+	{
+		addEntry(change.url, change.title, change.source, change.visits, change.lastVisit);
+	}
+}
+
+void AddressCompletionIndex::addEntry(const QString &url, const QString &title, EntrySource source, int visits, const QDateTime &lastVisit)
+{
+	if (url.isEmpty() || source == NoSource)
+	{
+		return;
+	}
+
+	int identifier = m_entryIdentifiers.value(url, -1);
+	const bool isNew = (identifier < 0);
+
+	if (!isNew)
+	{
+		invalidatePrefixes(identifier);
+	}
+
+	if (isNew)
+	{
+		if (m_freeEntries.isEmpty())
+		{
+			identifier = m_entries.count();
+
+			m_entries.append(Entry());
+		}
+		else
+		{
+			identifier = m_freeEntries.takeLast();
+
+			m_entries[identifier] = Entry();
+		}
+
+		m_entryIdentifiers[url] = identifier;
+	}
+
+	const bool replacesTitle = (!title.isEmpty() && title != m_entries.at(identifier).title && (source != HistorySource || m_entries.at(identifier).title.isEmpty()));
+	Entry &entry = m_entries[identifier];
+
+	if (isNew)
+	{
+		entry.url = url;
+		entry.normalizedUrl = url.toLower();
+	}
+
+	if (replacesTitle)
+	{
+		entry.title = title;
+	}
+
+	entry.sources |= source;
+
+	if (source == BookmarkSource)
+	{
+		entry.bookmarkVisits = visits;
+	}
+	else if (source == HistorySource)
+	{
+		entry.historyVisits = visits;
+	}
+	else if (source == TypedSource)
+	{
+		entry.typedVisits = visits;
+	}
+
+	if (lastVisit.isValid() && lastVisit.toTime_t() > entry.lastVisit)
+	{
+		entry.lastVisit = lastVisit.toTime_t();
+	}
+
+	updateScore(entry, QDateTime::currentDateTimeUtc().toTime_t());
+
+	if (isNew)
+	{
+		addKeys(identifier);
+		invalidatePrefixes(identifier);
+	}
+}
+
+void AddressCompletionIndex::addVisits(const QString &url, const QString &title, EntrySource source, int visits, const QDateTime &lastVisit)
+{
+	const int identifier = m_entryIdentifiers.value(url, -1);
+
+	if (identifier >= 0 && m_entries.at(identifier).sources.testFlag(source))
+	{
+		if (source == BookmarkSource)
+		{
+			visits += m_entries.at(identifier).bookmarkVisits;
+		}
+		else if (source == HistorySource)
+		{
+			visits += m_entries.at(identifier).historyVisits;
+		}
+		else if (source == TypedSource)
+		{
+			visits += m_entries.at(identifier).typedVisits;
+		}
+	}
+
+	addEntry(url, title, source, visits, lastVisit);
+}
+
+void AddressCompletionIndex::removeEntry(const QString &url, EntrySource source)
+{
+	const int identifier = m_entryIdentifiers.value(url, -1);
+
+	if (identifier < 0)
+	{
+		return;
+	}
+
+	invalidatePrefixes(identifier);
+
+	Entry &entry = m_entries[identifier];
+	entry.sources &= ~source;
+
+	if (source == BookmarkSource)
+	{
+		entry.bookmarkVisits = 0;
+	}
+	else if (source == HistorySource)
+	{
+		entry.historyVisits = 0;
+	}
+	else if (source == TypedSource)
+	{
+		entry.typedVisits = 0;
+	}
+
+	if (entry.sources == NoSource)
+	{
+		removeKeys(identifier);
+
+		m_entries[identifier] = Entry();
+		m_entryIdentifiers.remove(url);
+		m_freeEntries.append(identifier);
+
+		return;
+	}
+
+	updateScore(entry, QDateTime::currentDateTimeUtc().toTime_t());
+}
+
+void AddressCompletionIndex::removeSources(EntrySources sources)
+{
+	const uint now = QDateTime::currentDateTimeUtc().toTime_t();
+	QSet<int> removedEntries;
+	QHash<QString, int>::iterator iterator = m_entryIdentifiers.begin();
+
+	while (iterator != m_entryIdentifiers.end())
+	{
+		Entry &entry = m_entries[iterator.value()];
+
+		if (!(entry.sources & sources))
+		{
+			++iterator;
+
+			continue;
+		}
+
+		entry.sources &= ~sources;
+
+		if (sources.testFlag(BookmarkSource))
+		{
+			entry.bookmarkVisits = 0;
+		}
+
+		if (sources.testFlag(HistorySource))
+		{
+			entry.historyVisits = 0;
+		}
+
+		if (sources.testFlag(TypedSource))
+		{
+			entry.typedVisits = 0;
+		}
+
+		if (entry.sources == NoSource)
+		{
+			removedEntries.insert(iterator.value());
+
+			m_freeEntries.append(iterator.value());
+
+			iterator = m_entryIdentifiers.erase(iterator);
+		}
+		else
+		{
+			updateScore(entry, now);
+
+			++iterator;
+		}
+	}
+
+	m_prefixMatches.clear();
+
+	if (removedEntries.isEmpty())
+	{
+		return;
+	}
+
+	QVector<Key> keys;
+	keys.reserve(m_keys.count());
+
+	for (int i = 0; i < m_keys.count(); ++i)
+	{
+		if (!removedEntries.contains(m_keys.at(i).entry))
+		{
+			keys.append(m_keys.at(i));
+		}
+	}
+
+	m_keys = keys;
+
+	QSet<int>::const_iterator entriesIterator;
+
+	for (entriesIterator = removedEntries.constBegin(); entriesIterator != removedEntries.constEnd(); ++entriesIterator)
+	{
+		m_entries[*entriesIterator] = Entry();
+	}
+}
+
+void AddressCompletionIndex::clear()
+{
+	m_entries.clear();
+	m_keys.clear();
+	m_freeEntries.clear();
+	m_entryIdentifiers.clear();
+	m_prefixMatches.clear();
+
+	m_needsSorting = false;
+}
+
+void AddressCompletionIndex::addKeys(int entry)
+{
+	m_keys += createKeys(entry);
+
+	m_needsSorting = true;
+}
+
+void AddressCompletionIndex::removeKeys(int entry)
+{
+	if (m_needsSorting)
+	{
+		sortKeys();
+	}
+
+	const QVector<Key> keys = createKeys(entry);
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const QString text = getKeyText(m_entries.at(entry), keys.at(i)).toString();
+		QVector<Key>::iterator iterator = std::lower_bound(m_keys.begin(), m_keys.end(), text, KeyComparator(&m_entries));
+
+		while (iterator != m_keys.end() && getKeyText(m_entries.at(iterator->entry), *iterator) == text)
+		{
+			if (*iterator == keys.at(i))
+			{
+				m_keys.erase(iterator);
+
+				break;
+			}
+
+			++iterator;
+		}
+	}
+}
+
+void AddressCompletionIndex::invalidatePrefixes(int entry)
+{
+	if (m_prefixMatches.isEmpty())
+	{
+		return;
+	}
+
+	const QVector<Key> keys = createKeys(entry);
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const QStringRef text = getKeyText(m_entries.at(entry), keys.at(i));
+
+		for (int length = 1; length <= qMin(2, text.length()); ++length)
+		{
+			m_prefixMatches.remove(text.left(length).toString());
+		}
+	}
+}
+
+void AddressCompletionIndex::updateScore(Entry &entry, uint now) const
+{
+	const qreal recencyWeight = getRecencyWeight(entry.lastVisit, now);
+	qreal score = 0;
+
+	if (entry.sources.testFlag(SpecialPageSource))
+	{
+		score += 5;
+	}
+
+	if (entry.sources.testFlag(BookmarkSource))
+	{
+		score += (100 + (entry.bookmarkVisits * 10 * recencyWeight));
+	}
+
+	if (entry.sources.testFlag(HistorySource))
+	{
+		score += (entry.historyVisits * 20 * recencyWeight);
+	}
+
+	if (entry.sources.testFlag(TypedSource))
+	{
+		score = ((score + (entry.typedVisits * 20 * recencyWeight)) * 2);
+	}
+
+	entry.score = (score / (1 + (entry.url.length() * 0.01)));
+}
+
+void AddressCompletionIndex::sortKeys()
+{
+	std::sort(m_keys.begin(), m_keys.end(), KeyComparator(&m_entries));
+
+	m_needsSorting = false;
+}
+
+QList<AddressCompletionIndex::Match> AddressCompletionIndex::match(const QString &prefix, int limit)
+{
+	const QString text = prefix.trimmed().toLower();
+
+	if (text.isEmpty() || limit <= 0)
+	{
+		return QList<Match>();
+	}
+
+	if (m_needsSorting)
+	{
+		sortKeys();
+	}
+
+	QVector<QPair<qreal, Key> > candidates;
+
+	if (text.length() <= 2)
+	{
+		if (m_prefixMatches.contains(text) && m_prefixMatches[text].limit >= limit)
+		{
+			candidates = m_prefixMatches[text].candidates.mid(0, limit);
+		}
+		else
+		{
+			candidates = findCandidates(text, limit);
+
+			PrefixMatches prefixMatches;
+			prefixMatches.candidates = candidates;
+			prefixMatches.limit = limit;
+
+			m_prefixMatches[text] = prefixMatches;
+		}
+	}
+	else
+	{
+		candidates = findCandidates(text, limit);
+	}
+
+	QList<Match> matches;
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		const Entry &entry = m_entries.at(candidates.at(i).second.entry);
+		Match match;
+		match.completion = createCompletion(entry, candidates.at(i).second);
+		match.url = entry.url;
+		match.title = entry.title;
+		match.score = candidates.at(i).first;
+		match.sources = entry.sources;
+
+		matches.append(match);
+	}
+
+	return matches;
+}
+
+QVector<QPair<qreal, AddressCompletionIndex::Key> > AddressCompletionIndex::findCandidates(const QString &text, int limit) const
+{
+	QVector<QPair<qreal, Key> > candidates;
+	candidates.reserve(limit + 1);
+
+	for (QVector<Key>::const_iterator iterator = std::lower_bound(m_keys.constBegin(), m_keys.constEnd(), text, KeyComparator(&m_entries)); iterator != m_keys.constEnd(); ++iterator)
+	{
+		const Entry &entry = m_entries.at(iterator->entry);
+
+		if (!getKeyText(entry, *iterator).startsWith(text))
+		{
+			break;
+		}
+
+		const qreal score = entry.score;
+
+		if (candidates.count() == limit && score <= candidates.last().first)
+		{
+			continue;
+		}
+
+		int existing = -1;
+
+		for (int i = 0; i < candidates.count(); ++i)
+		{
+			if (candidates.at(i).second.entry == iterator->entry)
+			{
+				existing = i;
+
+				break;
+			}
+		}
+
+		if (existing >= 0)
+		{
+			if (candidates.at(existing).first >= score)
+			{
+				continue;
+			}
+
+			candidates.remove(existing);
+		}
+		else if (candidates.count() == limit)
+		{
+			candidates.removeLast();
+		}
+
+		int position = 0;
+
+		while (position < candidates.count() && candidates.at(position).first >= score)
+		{
+			++position;
+		}
+
+		candidates.insert(position, qMakePair(score, *iterator));
+	}
+
+	return candidates;
+}
+
+QVector<AddressCompletionIndex::Key> AddressCompletionIndex::createKeys(int entry) const
+{
+	const Entry &data = m_entries.at(entry);
+	QVector<Key> keys;
+	keys.append(Key(entry, 0, UrlKey));
+
+	const int hostOffset = data.normalizedUrl.indexOf(QLatin1String("://"));
+
+	if (hostOffset > 0 && (hostOffset + 3) < data.normalizedUrl.length())
+	{
+		keys.append(Key(entry, (hostOffset + 3), HostKey));
+
+		if (data.normalizedUrl.midRef(hostOffset + 3).startsWith(QLatin1String("www.")) && (hostOffset + 7) < data.normalizedUrl.length())
+		{
+			keys.append(Key(entry, (hostOffset + 7), DomainKey));
+		}
+	}
+
+	return keys;
+}
+
+QString AddressCompletionIndex::createCompletion(const Entry &entry, const Key &key) const
+{
+	if (key.type == HostKey || key.type == DomainKey)
+	{
+		return entry.url.mid(key.offset);
+	}
+
+	return entry.url;
+}
+
+QStringRef AddressCompletionIndex::getKeyText(const Entry &entry, const Key &key)
+{
+	return entry.normalizedUrl.midRef(key.offset);
+}
+
+qreal AddressCompletionIndex::getRecencyWeight(uint time, uint now)
+{
+	if (time == 0 || time > now)
+	{
+		return 0.1;
+	}
+
+	const uint days = ((now - time) / 86400);
+
+	if (days <= 4)
+	{
+		return 1;
+	}
+
+	if (days <= 14)
+	{
+		return 0.7;
+	}
+
+	if (days <= 31)
+	{
+		return 0.5;
+	}
+
+	if (days <= 90)
+	{
+		return 0.3;
+	}
+
+	return 0.1;
+}
+
+int AddressCompletionIndex::getEntriesAmount() const
+{
+	return m_entryIdentifiers.count();
+}
+
+bool AddressCompletionIndex::isEmpty() const
+{
+	return m_entryIdentifiers.isEmpty();
+}
+
+}
@@ -0,0 +1,163 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_ADDRESSCOMPLETIONINDEX_H
+#define OTTER_ADDRESSCOMPLETIONINDEX_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class AddressCompletionIndex
+{
+public:
+	enum EntrySource
+	{
+		NoSource = 0,
+		SpecialPageSource = 1,
+		BookmarkSource = 2,
+		HistorySource = 4,
+		TypedSource = 8
+	};
+
+	Q_DECLARE_FLAGS(EntrySources, EntrySource)
+
+	enum KeyType
+	{
+		UrlKey = 0,
+		HostKey = 1,
+		DomainKey = 2
+	};
+
+	struct Match
+	{
+		QString completion;
+		QString url;
+		QString title;
+		qreal score;
+		EntrySources sources;
+
+		Match() : score(0) {}
+	};
+
+	struct Change
+	{
+		QString url;
+		QString title;
+		QDateTime lastVisit;
+		EntrySource source;
+		int visits;
+		bool isRemoval;
+		bool isVisit;
+
+		Change() : source(NoSource), visits(0), isRemoval(false), isVisit(false) {}
+		Change(const QString &urlValue, const QString &titleValue, EntrySource sourceValue, int visitsValue = 0, const QDateTime &lastVisitValue = QDateTime()) : url(urlValue), title(titleValue), lastVisit(lastVisitValue), source(sourceValue), visits(visitsValue), isRemoval(false), isVisit(false) {}
+	};
+
+	AddressCompletionIndex();
+
+	void applyChange(const Change &change);
+	void addEntry(const QString &url, const QString &title, EntrySource source, int visits = 0, const QDateTime &lastVisit = QDateTime());
+	void addVisits(const QString &url, const QString &title, EntrySource source, int visits, const QDateTime &lastVisit);
+	void removeEntry(const QString &url, EntrySource source);
+	void removeSources(EntrySources sources);
+	void clear();
+	QList<Match> match(const QString &prefix, int limit);
+	int getEntriesAmount() const;
+	bool isEmpty() const;
+
+protected:
+	struct Entry
+	{
+		QString url;
+		QString title;
+		QString normalizedUrl;
+		qreal score;
+		uint lastVisit;
+		int bookmarkVisits;
+		int historyVisits;
+		int typedVisits;
+		EntrySources sources;
+
+		Entry() : score(0), lastVisit(0), bookmarkVisits(0), historyVisits(0), typedVisits(0) {}
+	};
+
+	struct Key
+	{
+		int entry;
+		int offset;
+		KeyType type;
+
+		Key() : entry(-1), offset(0), type(UrlKey) {}
+		Key(int entryValue, int offsetValue, KeyType typeValue) : entry(entryValue), offset(offsetValue), type(typeValue) {}
+
+		bool operator==(const Key &other) const
+		{
+			return (entry == other.entry && offset == other.offset && type == other.type);
+		}
+	};
+
+	class KeyComparator
+	{
+	public:
+		explicit KeyComparator(const QVector<Entry> *entries);
+
+		bool operator()(const Key &first, const Key &second) const;
+		bool operator()(const Key &key, const QString &text) const;
+		bool operator()(const QString &text, const Key &key) const;
+
+	private:
+		const QVector<Entry> *m_entries;
+	};
+
+	struct PrefixMatches
+	{
+		QVector<QPair<qreal, Key> > candidates;
+		int limit;
+
+		PrefixMatches() : limit(0) {}
+	};
+
+	void addKeys(int entry);
+	void removeKeys(int entry);
+	void invalidatePrefixes(int entry);
+	void updateScore(Entry &entry, uint now) const;
+	void sortKeys();
+	QVector<QPair<qreal, Key> > findCandidates(const QString &text, int limit) const;
+	QVector<Key> createKeys(int entry) const;
+	QString createCompletion(const Entry &entry, const Key &key) const;
+	static QStringRef getKeyText(const Entry &entry, const Key &key);
+	static qreal getRecencyWeight(uint time, uint now);
+
+private:
+	QVector<Entry> m_entries;
+	QVector<Key> m_keys;
+	QVector<int> m_freeEntries;
+	QHash<QString, int> m_entryIdentifiers;
+	QHash<QString, PrefixMatches> m_prefixMatches;
+	bool m_needsSorting;
+};
+
+}
+
+#endif
@@ -1,6 +1,6 @@
 /**************************************************************************
 * Otter Browser: Web browser controlled by the user, not vice-versa.
-* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+* Copyright (C) 2013 - 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
 *
 * This program is free software: you can redistribute it and/or modify
 * it under the terms of the GNU General Public License as published by
@@ -18,10 +18,15 @@
 **************************************************************************/
 
 #include "AddressCompletionModel.h"
+#include "AddressCompletionWorker.h"
 #include "BookmarksManager.h"
+#include "BookmarksModel.h"
+#include "HistoryManager.h"
+#include "SessionsManager.h"
 #include "SettingsManager.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QSet>
 
 namespace Otter
 {
@@ -29,31 +34,163 @@ namespace Otter
 AddressCompletionModel* AddressCompletionModel::m_instance = NULL;
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
-	m_updateTimer(0)
+	m_thread(new QThread(this)),
+	m_worker(new AddressCompletionWorker()),
+	m_query(0),
+	m_matchesQuery(0),
+	m_changesTimer(0),
+	m_updateTimer(0),
+	m_needsHistoryReload(false)
 {
+	qRegisterMetaType<QList<AddressCompletionIndex::Change> >("QList<AddressCompletionIndex::Change>");
+	qRegisterMetaType<QList<AddressCompletionIndex::Match> >("QList<AddressCompletionIndex::Match>");
+
+	m_worker->moveToThread(m_thread);
+	m_thread->start();
+
 	m_updateTimer = startTimer(250);
 
-	connect(BookmarksManager::getInstance(), SIGNAL(modelModified()), this, SLOT(updateCompletion()));
+	connect(this, SIGNAL(requestedRebuild(QList<AddressCompletionIndex::Change>,QString)), m_worker, SLOT(rebuild(QList<AddressCompletionIndex::Change>,QString)));
+	connect(this, SIGNAL(requestedUpdate(QList<AddressCompletionIndex::Change>)), m_worker, SLOT(update(QList<AddressCompletionIndex::Change>)));
+	connect(this, SIGNAL(requestedHistoryReload(QString)), m_worker, SLOT(reloadHistory(QString)));
+	connect(this, SIGNAL(requestedMatch(int,QString,int)), m_worker, SLOT(match(int,QString,int)));
+	connect(m_worker, SIGNAL(matchesReady(int,QList<AddressCompletionIndex::Match>,bool)), this, SLOT(addMatches(int,QList<AddressCompletionIndex::Match>,bool)));
+
+	connect(BookmarksManager::getModel(), SIGNAL(bookmarkAdded(BookmarksItem*)), this, SLOT(addBookmark(BookmarksItem*)));
+	connect(BookmarksManager::getModel(), SIGNAL(bookmarkModified(BookmarksItem*)), this, SLOT(addBookmark(BookmarksItem*)));
+	connect(BookmarksManager::getModel(), SIGNAL(bookmarkRemoved(QUrl)), this, SLOT(removeBookmark(QUrl)));
+	connect(HistoryManager::getInstance(), SIGNAL(cleared()), this, SLOT(reloadHistory()));
+	connect(HistoryManager::getInstance(), SIGNAL(entryAdded(qint64)), this, SLOT(addHistoryEntry(qint64)));
+	connect(HistoryManager::getInstance(), SIGNAL(entryUpdated(qint64)), this, SLOT(updateHistoryEntry(qint64)));
+	connect(HistoryManager::getInstance(), SIGNAL(entryRemoved(qint64)), this, SLOT(reloadHistory()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
 }
 
+AddressCompletionModel::~AddressCompletionModel()
+{
+	m_worker->setLatestQuery(-1);
+
+	m_thread->quit();
+	m_thread->wait();
+
+	delete m_worker;
+}
+
 void AddressCompletionModel::timerEvent(QTimerEvent *event)
 {
-	if (event->timerId() == m_updateTimer)
+	if (event->timerId() == m_changesTimer)
+	{
+		killTimer(m_changesTimer);
+
+		m_changesTimer = 0;
+
+		QList<AddressCompletionIndex::Change> changes = m_changes;
+
+		for (int i = 0; i < m_removedUrls.count(); ++i)
+		{
+			if (!BookmarksManager::hasBookmark(m_removedUrls.at(i)))
+			{
+				AddressCompletionIndex::Change change(m_removedUrls.at(i), QString(), AddressCompletionIndex::BookmarkSource);
+				change.isRemoval = true;
+
+				changes.append(change);
+			}
+		}
+
+		if (m_needsHistoryReload)
+		{
+			emit requestedHistoryReload(HistoryManager::isEnabled() ? (SessionsManager::getProfilePath() + QLatin1String("/browsingHistory.sqlite")) : QString());
+		}
+		else
+		{
+			changes.append(m_historyChanges);
+		}
+
+		const bool needsUpdate = (m_needsHistoryReload || !changes.isEmpty());
+
+		m_changes.clear();
+		m_historyChanges.clear();
+		m_removedUrls.clear();
+
+		m_needsHistoryReload = false;
+
+		if (!changes.isEmpty())
+		{
+			emit requestedUpdate(changes);
+		}
+
+		if (needsUpdate && !m_filter.trimmed().isEmpty())
+		{
+			setFilter(m_filter);
+		}
+	}
+	else if (event->timerId() == m_updateTimer)
 	{
 		killTimer(m_updateTimer);
 
 		m_updateTimer = 0;
 
-		QStringList urls;
-		urls << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:transfers");
-		urls << BookmarksManager::getUrls();
+		if (m_changesTimer != 0)
+		{
+			killTimer(m_changesTimer);
+
+			m_changesTimer = 0;
+		}
+
+		m_changes.clear();
+		m_historyChanges.clear();
+		m_removedUrls.clear();
+
+		m_needsHistoryReload = false;
 
-		beginResetModel();
+		QList<AddressCompletionIndex::Change> changes;
+		const QStringList specialPages = QStringList() << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:network") << QLatin1String("about:transfers");
 
-		m_urls = urls;
+		for (int i = 0; i < specialPages.count(); ++i)
+		{
+			changes.append(AddressCompletionIndex::Change(specialPages.at(i), QString(), AddressCompletionIndex::SpecialPageSource));
+		}
 
-		endResetModel();
+		if (SettingsManager::getValue(QLatin1String("AddressField/SuggestBookmarks")).toBool())
+		{
+			addBookmarks(BookmarksManager::getModel()->getRootItem(), changes);
+		}
+
+		emit requestedRebuild(changes, (HistoryManager::isEnabled() ? (SessionsManager::getProfilePath() + QLatin1String("/browsingHistory.sqlite")) : QString()));
+
+		if (!m_filter.trimmed().isEmpty())
+		{
+			setFilter(m_filter);
+		}
+	}
+}
+
+void AddressCompletionModel::addBookmarks(QStandardItem *branch, QList<AddressCompletionIndex::Change> &changes)
+{
+	if (!branch)
+	{
+		return;
+	}
+
+	for (int i = 0; i < branch->rowCount(); ++i)
+	{
+		QStandardItem *item = branch->child(i, 0);
+
+		if (!item)
+		{
+			continue;
+		}
+
+		const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(item->data(BookmarksModel::TypeRole).toInt());
+
+		if (type == BookmarksItem::FolderBookmark)
+		{
+			addBookmarks(item, changes);
+		}
+		else if (type == BookmarksItem::UrlBookmark)
+		{
+			changes.append(AddressCompletionIndex::Change(item->data(BookmarksModel::UrlRole).toUrl().toString(), item->data(BookmarksModel::TitleRole).toString(), AddressCompletionIndex::BookmarkSource, item->data(BookmarksModel::VisitsRole).toInt(), item->data(BookmarksModel::TimeVisitedRole).toDateTime()));
+		}
 	}
 }
 
@@ -65,6 +202,109 @@ void AddressCompletionModel::optionChanged(const QString &option)
 	}
 }
 
+void AddressCompletionModel::addBookmark(BookmarksItem *bookmark)
+{
+	if (!bookmark || !SettingsManager::getValue(QLatin1String("AddressField/SuggestBookmarks")).toBool())
+	{
+		return;
+	}
+
+	m_changes.append(AddressCompletionIndex::Change(bookmark->data(BookmarksModel::UrlRole).toUrl().toString(), bookmark->data(BookmarksModel::TitleRole).toString(), AddressCompletionIndex::BookmarkSource, bookmark->data(BookmarksModel::VisitsRole).toInt(), bookmark->data(BookmarksModel::TimeVisitedRole).toDateTime()));
+
+	scheduleUpdate();
+}
+
+void AddressCompletionModel::removeBookmark(const QUrl &url)
+{
+	if (!url.isEmpty())
+	{
+		m_removedUrls.append(url.toString());
+
+		scheduleUpdate();
+	}
+}
+
+void AddressCompletionModel::addHistoryEntry(qint64 entry)
+{
+	const HistoryEntry historyEntry = HistoryManager::getEntry(entry);
+
+	if (!historyEntry.url.isValid())
+	{
+		return;
+	}
+
+	AddressCompletionIndex::Change change(historyEntry.url.toString(), historyEntry.title, AddressCompletionIndex::HistorySource, 1, historyEntry.time);
+	change.isVisit = true;
+
+	m_historyChanges.append(change);
+
+	if (historyEntry.typed)
+	{
+		change.source = AddressCompletionIndex::TypedSource;
+
+		m_historyChanges.append(change);
+	}
+
+	scheduleUpdate();
+}
+
+void AddressCompletionModel::updateHistoryEntry(qint64 entry)
+{
+	const HistoryEntry historyEntry = HistoryManager::getEntry(entry);
+
+	if (!historyEntry.url.isValid())
+	{
+		return;
+	}
+
+	AddressCompletionIndex::Change change(historyEntry.url.toString(), historyEntry.title, AddressCompletionIndex::HistorySource, 0, historyEntry.time);
+	change.isVisit = true;
+
+	m_historyChanges.append(change);
+
+	scheduleUpdate();
+}
+
+void AddressCompletionModel::reloadHistory()
+{
+	m_needsHistoryReload = true;
+
+	scheduleUpdate();
+}
+
+void AddressCompletionModel::addMatches(int query, const QList<AddressCompletionIndex::Match> &matches, bool isFinal)
+{
+	if (query != m_query)
+	{
+		return;
+	}
+
+	if (m_matchesQuery != query)
+	{
+		m_matchesQuery = query;
+
+		setMatches(matches);
+	}
+	else if (!matches.isEmpty())
+	{
+		beginInsertRows(QModelIndex(), m_matches.count(), (m_matches.count() + matches.count() - 1));
+
+		m_matches.append(matches);
+
+		endInsertRows();
+	}
+
+	emit completionReady(m_filter, isFinal);
+}
+
+void AddressCompletionModel::scheduleUpdate()
+{
+	if (m_changesTimer == 0 && m_updateTimer == 0)
+	{
+		m_changesTimer = startTimer(100);
+	}
+}
+
 void AddressCompletionModel::updateCompletion()
 {
 	if (m_updateTimer == 0)
@@ -83,11 +323,116 @@ AddressCompletionModel* AddressCompletionModel::getInstance()
 	return m_instance;
 }
 
+void AddressCompletionModel::setFilter(const QString &filter)
+{
+	m_filter = filter;
+
+	++m_query;
+
+	m_worker->setLatestQuery(m_query);
+
+	if (filter.trimmed().isEmpty())
+	{
+		m_matchesQuery = m_query;
+
+		setMatches(QList<AddressCompletionIndex::Match>());
+
+		return;
+	}
+
+	emit requestedMatch(m_query, filter, 10);
+}
+
+void AddressCompletionModel::setMatches(const QList<AddressCompletionIndex::Match> &matches)
+{
+	QSet<QString> urls;
+
+	for (int i = 0; i < matches.count(); ++i)
+	{
+		urls.insert(matches.at(i).url);
+	}
+
+	for (int i = (m_matches.count() - 1); i >= 0; --i)
+	{
+		if (!urls.contains(m_matches.at(i).url))
+		{
+			beginRemoveRows(QModelIndex(), i, i);
+
+			m_matches.removeAt(i);
+
+			endRemoveRows();
+		}
+	}
+
+	for (int i = 0; i < matches.count(); ++i)
+	{
+		if (i < m_matches.count() && m_matches.at(i).url == matches.at(i).url)
+		{
+			const bool isChanged = (m_matches.at(i).completion != matches.at(i).completion || m_matches.at(i).title != matches.at(i).title);
+
+			m_matches[i] = matches.at(i);
+
+			if (isChanged)
+			{
+				emit dataChanged(index(i), index(i));
+			}
+
+			continue;
+		}
+
+		for (int j = (i + 1); j < m_matches.count(); ++j)
+		{
+			if (m_matches.at(j).url == matches.at(i).url)
+			{
+				beginRemoveRows(QModelIndex(), j, j);
+
+				m_matches.removeAt(j);
+
+				endRemoveRows();
+
+				break;
+			}
+		}
+
+		beginInsertRows(QModelIndex(), i, i);
+
+		m_matches.insert(i, matches.at(i));
+
+		endInsertRows();
+	}
+
+	if (m_matches.count() > matches.count())
+	{
+		beginRemoveRows(QModelIndex(), matches.count(), (m_matches.count() - 1));
+
+		while (m_matches.count() > matches.count())
+		{
+			m_matches.removeLast();
+		}
+
+		endRemoveRows();
+	}
+}
+
 QVariant AddressCompletionModel::data(const QModelIndex &index, int role) const
 {
-	if (role == Qt::DisplayRole && index.column() == 0 && index.row() >= 0 && index.row() < m_urls.count())
+	if (index.column() != 0 || index.row() < 0 || index.row() >= m_matches.count())
+	{
+		return QVariant();
+	}
+
+	switch (role)
 	{
-		return m_urls.at(index.row());
+		case Qt::DisplayRole:
+		case Qt::EditRole:
+			return m_matches.at(index.row()).completion;
+		case Qt::ToolTipRole:
+		case TitleRole:
+			return m_matches.at(index.row()).title;
+		case UrlRole:
+			return m_matches.at(index.row()).url;
+		default:
+			break;
 	}
 
 	return QVariant();
@@ -104,7 +449,7 @@ QVariant AddressCompletionModel::headerData(int section, Qt::Orientation orienta
 
 int AddressCompletionModel::rowCount(const QModelIndex &index) const
 {
-	return (index.isValid() ? 0 : m_urls.count());
+	return (index.isValid() ? 0 : m_matches.count());
 }
 
 }
@@ -20,35 +20,78 @@
 #ifndef OTTER_ADDRESSCOMPLETIONMODEL_H
 #define OTTER_ADDRESSCOMPLETIONMODEL_H
 
+#include "AddressCompletionIndex.h"
+
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QThread>
+#include <QtCore/QUrl>
+#include <QtGui/QStandardItem>
 
 namespace Otter
 {
 
+class AddressCompletionWorker;
+class BookmarksItem;
+
 class AddressCompletionModel : public QAbstractListModel
 {
 	Q_OBJECT
 
 public:
+	enum CompletionRole
+	{
+		UrlRole = Qt::UserRole,
+		TitleRole = (Qt::UserRole + 1)
+	};
+
+	~AddressCompletionModel();
+
 	static AddressCompletionModel* getInstance();
+	void setFilter(const QString &filter);
 	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
 	int rowCount(const QModelIndex &index = QModelIndex()) const;
 
 protected:
 	void timerEvent(QTimerEvent *event);
+	void addBookmarks(QStandardItem *branch, QList<AddressCompletionIndex::Change> &changes);
+	void setMatches(const QList<AddressCompletionIndex::Match> &matches);
 
 protected slots:
 	void optionChanged(const QString &option);
+	void addBookmark(BookmarksItem *bookmark);
+	void removeBookmark(const QUrl &url);
+	void addHistoryEntry(qint64 entry);
+	void updateHistoryEntry(qint64 entry);
+	void reloadHistory();
+	void addMatches(int query, const QList<AddressCompletionIndex::Match> &matches, bool isFinal);
+	void scheduleUpdate();
 	void updateCompletion();
 
 private:
 	explicit AddressCompletionModel(QObject *parent = NULL);
 
-	QStringList m_urls;
+	QThread *m_thread;
+	AddressCompletionWorker *m_worker;
+	QList<AddressCompletionIndex::Match> m_matches;
+	QList<AddressCompletionIndex::Change> m_changes;
+	QList<AddressCompletionIndex::Change> m_historyChanges;
+	QStringList m_removedUrls;
+	QString m_filter;
+	int m_query;
+	int m_matchesQuery;
+	int m_changesTimer;
 	int m_updateTimer;
+	bool m_needsHistoryReload;
 
 	static AddressCompletionModel *m_instance;
+
+signals:
+	void requestedRebuild(const QList<AddressCompletionIndex::Change> &changes, const QString &historyPath);
+	void requestedUpdate(const QList<AddressCompletionIndex::Change> &changes);
+	void requestedHistoryReload(const QString &historyPath);
+	void requestedMatch(int query, const QString &filter, int limit);
+	void completionReady(const QString &filter, bool isFinal);
 };
 
 }
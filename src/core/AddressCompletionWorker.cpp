@@ -0,0 +1,180 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "AddressCompletionWorker.h"
+#include "HistoryManager.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QUrl>
+
+namespace Otter
+{
+
+AddressCompletionWorker::AddressCompletionWorker(QObject *parent) : QObject(parent),
+	m_latestQuery(0)
+{
+}
+
+void AddressCompletionWorker::setLatestQuery(int query)
+{
+	m_latestQuery.fetchAndStoreOrdered(query);
+}
+
+void AddressCompletionWorker::rebuild(const QList<AddressCompletionIndex::Change> &changes, const QString &historyPath)
+{
+	m_index.clear();
+
+	for (int i = 0; i < changes.count(); ++i)
+	{
+		m_index.applyChange(changes.at(i));
+	}
+
+	loadHistory(historyPath);
+}
+
+void AddressCompletionWorker::update(const QList<AddressCompletionIndex::Change> &changes)
+{
+	for (int i = 0; i < changes.count(); ++i)
+	{
+		m_index.applyChange(changes.at(i));
+	}
+}
+
+void AddressCompletionWorker::reloadHistory(const QString &historyPath)
+{
+	m_index.removeSources(AddressCompletionIndex::HistorySource | AddressCompletionIndex::TypedSource);
+
+	loadHistory(historyPath);
+}
+
+void AddressCompletionWorker::loadHistory(const QString &path)
+{
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QList<HistoryEntry> entries;
+
+	{
+		QSqlDatabase database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), QLatin1String("addressCompletion"));
+		database.setDatabaseName(path);
+
+		if (database.open())
+		{
+			entries = HistoryManager::getLocations(database);
+
+			database.close();
+		}
+	}
+
+	QSqlDatabase::removeDatabase(QLatin1String("addressCompletion"));
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QString url = entries.at(i).url.toString();
+
+		m_index.addEntry(url, entries.at(i).title, AddressCompletionIndex::HistorySource, entries.at(i).visits, entries.at(i).time);
+
+		if (entries.at(i).typed)
+		{
+			m_index.addEntry(url, entries.at(i).title, AddressCompletionIndex::TypedSource, 1, entries.at(i).time);
+		}
+	}
+}
+
+void AddressCompletionWorker::match(int query, const QString &filter, int limit)
+{
+	if (isCancelled(query))
+	{
+		return;
+	}
+
+	emit matchesReady(query, m_index.match(filter, limit), false);
+
+	if (isCancelled(query))
+	{
+		return;
+	}
+
+	emit matchesReady(query, matchLocalPaths(query, filter, limit), true);
+}
+
+QList<AddressCompletionIndex::Match> AddressCompletionWorker::matchLocalPaths(int query, const QString &filter, int limit) const
+{
+	QList<AddressCompletionIndex::Match> matches;
+	QString prefix;
+	QString path = QDir::fromNativeSeparators(filter);
+
+	if (path.startsWith(QLatin1String("file://"), Qt::CaseInsensitive))
+	{
+		prefix = filter.left(7);
+		path = path.mid(7);
+	}
+
+	QString localPath = path;
+
+	if (localPath == QLatin1String("~") || localPath.startsWith(QLatin1String("~/")))
+	{
+		localPath = QDir::homePath() + localPath.mid(1);
+	}
+
+	if (!QDir::isAbsolutePath(localPath))
+	{
+		return matches;
+	}
+
+	const QString directory = (prefix + filter.mid(prefix.length(), (path.lastIndexOf(QLatin1Char('/')) + 1)));
+	const int separator = localPath.lastIndexOf(QLatin1Char('/'));
+	QDirIterator iterator(localPath.left(separator + 1), QStringList(localPath.mid(separator + 1) + QLatin1Char('*')), (QDir::AllEntries | QDir::NoDotAndDotDot));
+	QStringList names;
+
+	while (iterator.hasNext() && names.count() < limit)
+	{
+		if (isCancelled(query))
+		{
+			return QList<AddressCompletionIndex::Match>();
+		}
+
+		iterator.next();
+
+		names.append(iterator.fileName() + (iterator.fileInfo().isDir() ? QLatin1String("/") : QString()));
+	}
+
+	names.sort(Qt::CaseInsensitive);
+
+	for (int i = 0; i < names.count(); ++i)
+	{
+		AddressCompletionIndex::Match match;
+		match.completion = directory + names.at(i);
+		match.url = QUrl::fromLocalFile(localPath.left(separator + 1) + names.at(i)).toString();
+
+		matches.append(match);
+	}
+
+	return matches;
+}
+
+bool AddressCompletionWorker::isCancelled(int query) const
+{
+	return (query != m_latestQuery.load());
+}
+
+}
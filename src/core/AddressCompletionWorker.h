@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_ADDRESSCOMPLETIONWORKER_H
+#define OTTER_ADDRESSCOMPLETIONWORKER_H
+
+#include "AddressCompletionIndex.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QObject>
+
+namespace Otter
+{
+
+class AddressCompletionWorker : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit AddressCompletionWorker(QObject *parent = NULL);
+
+	void setLatestQuery(int query);
+
+public slots:
+	void rebuild(const QList<AddressCompletionIndex::Change> &changes, const QString &historyPath);
+	void update(const QList<AddressCompletionIndex::Change> &changes);
+	void reloadHistory(const QString &historyPath);
+	void match(int query, const QString &filter, int limit);
+
+protected:
+	void loadHistory(const QString &path);
+	QList<AddressCompletionIndex::Match> matchLocalPaths(int query, const QString &filter, int limit) const;
+	bool isCancelled(int query) const;
+
+private:
+	AddressCompletionIndex m_index;
+	QAtomicInt m_latestQuery;
+
+signals:
+	void matchesReady(int query, const QList<AddressCompletionIndex::Match> &matches, bool isFinal);
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "AddonsManager.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "FaviconsCache.h"
 #include "HistoryManager.h"
 #include "NetworkManagerFactory.h"
 #include "SearchesManager.h"
@@ -185,6 +186,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	NetworkManagerFactory::createInstance(this);
 
+	FaviconsCache::createInstance(this);
+
 	BookmarksManager::createInstance(this);
 
 	HistoryManager::createInstance(this);
@@ -426,6 +429,10 @@ QCommandLineParser* Application::createCommandLineParser() const
 	parser->addOption(QCommandLineOption(QLatin1String("session"), QCoreApplication::translate("main", "Restores session <session> if it exists"), QLatin1String("session"), QString()));
 	parser->addOption(QCommandLineOption(QLatin1String("privatesession"), QCoreApplication::translate("main", "Starts private session")));
 	parser->addOption(QCommandLineOption(QLatin1String("portable"), QCoreApplication::translate("main", "Sets profile and cache paths to directories inside the same directory as that of application binary")));
+	parser->addOption(QCommandLineOption(QLatin1String("replay"), QCoreApplication::translate("main", "Serves HTTP responses from HAR file or directory of HAR files <path> instead of network"), QLatin1String("path"), QString()));
+	parser->addOption(QCommandLineOption(QLatin1String("replay-latency"), QCoreApplication::translate("main", "Delays each replayed response by <time> milliseconds"), QLatin1String("time"), QLatin1String("0")));
+	parser->addOption(QCommandLineOption(QLatin1String("replay-bandwidth"), QCoreApplication::translate("main", "Limits each replayed response to <speed> KiB per second"), QLatin1String("speed"), QLatin1String("0")));
+	parser->addOption(QCommandLineOption(QLatin1String("benchmark"), QCoreApplication::translate("main", "Loads URLs listed in file <path> one by one, prints load timings and exits"), QLatin1String("path"), QString()));
 
 	return parser;
 }
@@ -0,0 +1,93 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BookmarksFilterModel.h"
+#include "BookmarksModel.h"
+
+namespace Otter
+{
+
+BookmarksFilterModel::BookmarksFilterModel(BookmarksModel *model, QObject *parent) : QSortFilterProxyModel(parent),
+	m_model(model),
+	m_isFiltering(false)
+{
+	setSourceModel(model);
+
+	connect(model, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(updateFilter()));
+	connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateFilter()));
+	connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(updateFilter()));
+}
+
+void BookmarksFilterModel::updateFilter()
+{
+	if (m_isFiltering)
+	{
+		setFilter(m_filter);
+	}
+}
+
+void BookmarksFilterModel::setFilter(const QString &filter)
+{
+	m_visibleItems.clear();
+
+	m_filter = filter;
+
+	m_isFiltering = !filter.isEmpty();
+
+	if (m_isFiltering)
+	{
+		const QList<QStandardItem*> bookmarks = m_model->findBookmarks(filter);
+
+		for (int i = 0; i < bookmarks.count(); ++i)
+		{
+			QStandardItem *item = bookmarks.at(i);
+
+			while (item && !m_visibleItems.contains(item))
+			{
+				m_visibleItems.insert(item);
+
+				item = item->parent();
+			}
+		}
+	}
+
+	invalidateFilter();
+}
+
+QStandardItem* BookmarksFilterModel::getItem(const QModelIndex &index) const
+{
+	return m_model->itemFromIndex(mapToSource(index));
+}
+
+QModelIndex BookmarksFilterModel::getIndex(QStandardItem *item) const
+{
+	return (item ? mapFromSource(item->index()) : QModelIndex());
+}
+
+bool BookmarksFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+	if (!m_isFiltering)
+	{
+		return true;
+	}
+
+	return m_visibleItems.contains(m_model->itemFromIndex(m_model->index(sourceRow, 0, sourceParent)));
+}
+
+}
@@ -0,0 +1,58 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_BOOKMARKSFILTERMODEL_H
+#define OTTER_BOOKMARKSFILTERMODEL_H
+
+#include <QtCore/QSet>
+#include <QtCore/QSortFilterProxyModel>
+#include <QtGui/QStandardItem>
+
+namespace Otter
+{
+
+class BookmarksModel;
+
+class BookmarksFilterModel : public QSortFilterProxyModel
+{
+	Q_OBJECT
+
+public:
+	explicit BookmarksFilterModel(BookmarksModel *model, QObject *parent = NULL);
+
+	void setFilter(const QString &filter);
+	QStandardItem* getItem(const QModelIndex &index) const;
+	QModelIndex getIndex(QStandardItem *item) const;
+
+protected:
+	bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+
+protected slots:
+	void updateFilter();
+
+private:
+	BookmarksModel *m_model;
+	QSet<QStandardItem*> m_visibleItems;
+	QString m_filter;
+	bool m_isFiltering;
+};
+
+}
+
+#endif
@@ -24,7 +24,8 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QFile>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QSaveFile>
 #include <QtCore/QSet>
 #include <QtCore/QTimer>
 #include <QtCore/QUrl>
@@ -37,7 +38,11 @@ BookmarksManager* BookmarksManager::m_instance = NULL;
 BookmarksModel* BookmarksManager::m_model = NULL;
 
 BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent),
-	 m_saveTimer(0)
+	m_loadingWatcher(NULL),
+	m_compactionWatcher(NULL),
+	m_journal(NULL),
+	m_saveTimer(0),
+	m_needsCompaction(false)
 {
 }
 
@@ -49,7 +54,7 @@ void BookmarksManager::timerEvent(QTimerEvent *event)
 
 		m_saveTimer = 0;
 
-		save();
+		compact();
 	}
 }
 
@@ -58,28 +63,478 @@ void BookmarksManager::createInstance(QObject *parent)
 	if (!m_instance)
 	{
 		m_instance = new BookmarksManager(parent);
+
+		getModel();
+	}
+}
+
+void BookmarksManager::load()
+{
+	const QString path = SessionsManager::getProfilePath() + QLatin1String("/bookmarks.xbel");
+
+	if (!QFile::exists(path))
+	{
+		if (replayJournal(getJournalPath(true)) + replayJournal(getJournalPath()) > 0)
+		{
+			compact();
+		}
+
+		watchModel();
+
+		return;
 	}
+
+	m_loadingWatcher = new QFutureWatcher<BookmarksTree>(this);
+
+	connect(m_loadingWatcher, SIGNAL(finished()), this, SLOT(loadingFinished()));
+
+	m_loadingWatcher->setFuture(QtConcurrent::run(&BookmarksManager::readBookmarks, path));
+}
+
+void BookmarksManager::loadingFinished()
+{
+	const BookmarksTree tree = m_loadingWatcher->result();
+
+	m_loadingWatcher->deleteLater();
+	m_loadingWatcher = NULL;
+
+	if (!tree.isValid)
+	{
+		if (tree.error != QXmlStreamReader::NoError)
+		{
+			QMessageBox::warning(NULL, tr("Error"), tr("Failed to parse bookmarks file. No bookmarks were loaded."), QMessageBox::Close);
+			Console::addMessage(tr("Failed to load bookmarks file properly, QXmlStreamReader error code: %1").arg(tree.error), OtherMessageCategory, ErrorMessageLevel);
+		}
+		else
+		{
+			Console::addMessage(tr("Failed to open bookmarks file: %0").arg(tree.errorString), OtherMessageCategory, ErrorMessageLevel);
+		}
+
+		return;
+	}
+
+	QStandardItem *rootItem = m_model->getRootItem();
+	QList<QList<QStandardItem*> > preloadedRows;
+
+	while (rootItem->rowCount() > 0)
+	{
+		preloadedRows.append(rootItem->takeRow(0));
+	}
+
+	const QList<QStandardItem*> items = createItems(tree.nodes);
+
+	if (!items.isEmpty())
+	{
+		rootItem->insertRows(0, items);
+	}
+
+	const int replayedAmount = (replayJournal(getJournalPath(true)) + replayJournal(getJournalPath()));
+
+	for (int i = 0; i < preloadedRows.count(); ++i)
+	{
+		rootItem->appendRow(preloadedRows.at(i));
+	}
+
+	watchModel();
+
+	if (!preloadedRows.isEmpty() || replayedAmount > 0)
+	{
+		compact();
+	}
+
+	emit modelModified();
+}
+
+void BookmarksManager::watchModel()
+{
+	connect(m_model, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(recordChange(QStandardItem*)));
+	connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(recordInsertion(QModelIndex,int,int)));
+	connect(m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(recordRemoval(QModelIndex,int,int)));
+	connect(m_model, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(recordMove(QModelIndex,int,int,QModelIndex,int)));
 }
 
 void BookmarksManager::scheduleSave()
 {
-	if (m_saveTimer == 0)
+	if (m_journal && m_journal->size() > 524288)
 	{
-		m_saveTimer = startTimer(1000);
+		compact();
+	}
+	else
+	{
+		if (m_saveTimer != 0)
+		{
+			killTimer(m_saveTimer);
+		}
+
+		m_saveTimer = startTimer(60000);
 	}
 
 	emit modelModified();
 }
 
-void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *parent)
+void BookmarksManager::compact()
 {
-	BookmarksItem *bookmark = NULL;
+	if (m_saveTimer != 0)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+	}
+
+	if (m_compactionWatcher)
+	{
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	if (m_journal)
+	{
+		m_journal->close();
+		m_journal->deleteLater();
+		m_journal = NULL;
+	}
+
+	const QString journalPath = getJournalPath();
+	const QString compactedJournalPath = getJournalPath(true);
+
+	if (QFile::exists(journalPath))
+	{
+		if (QFile::exists(compactedJournalPath))
+		{
+			QFile source(journalPath);
+			QFile target(compactedJournalPath);
+
+			if (source.open(QIODevice::ReadOnly) && target.open(QIODevice::Append))
+			{
+				source.read(8);
+
+				target.write(source.readAll());
+			}
+
+			source.close();
+			source.remove();
+		}
+		else
+		{
+			QFile::rename(journalPath, compactedJournalPath);
+		}
+	}
+
+	m_needsCompaction = false;
+	m_compactionWatcher = new QFutureWatcher<bool>(this);
+
+	connect(m_compactionWatcher, SIGNAL(finished()), this, SLOT(compactionFinished()));
+
+	m_compactionWatcher->setFuture(QtConcurrent::run(&BookmarksManager::writeBookmarks, SessionsManager::getProfilePath() + QLatin1String("/bookmarks.xbel"), createSnapshot(), compactedJournalPath));
+}
+
+void BookmarksManager::compactionFinished()
+{
+	if (!m_compactionWatcher->result())
+	{
+		Console::addMessage(tr("Failed to save bookmarks file"), OtherMessageCategory, ErrorMessageLevel);
+	}
+
+	m_compactionWatcher->deleteLater();
+	m_compactionWatcher = NULL;
+
+	if (m_needsCompaction)
+	{
+		compact();
+	}
+}
+
+void BookmarksManager::writeJournal(const QByteArray &record)
+{
+	if (!m_journal)
+	{
+		m_journal = new QFile(getJournalPath(), this);
+
+		if (!m_journal->open(QIODevice::Append))
+		{
+			Console::addMessage(tr("Failed to open bookmarks journal: %0").arg(m_journal->errorString()), OtherMessageCategory, ErrorMessageLevel);
+
+			m_journal->deleteLater();
+			m_journal = NULL;
+
+			compact();
+
+			return;
+		}
+
+		if (m_journal->size() == 0)
+		{
+			QDataStream stream(m_journal);
+			stream << quint32(0x4f424a4c) << quint32(1);
+		}
+	}
+
+	m_journal->write(record);
+	m_journal->flush();
+
+	scheduleSave();
+}
+
+int BookmarksManager::replayJournal(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return 0;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_2);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4f424a4c || version != 1)
+	{
+		Console::addMessage(tr("Failed to replay bookmarks journal: unsupported format"), OtherMessageCategory, ErrorMessageLevel);
+
+		return 0;
+	}
+
+	int amount = 0;
+
+	while (!stream.atEnd())
+	{
+		quint8 operation = UnknownOperation;
+		QVector<int> path;
+		QVector<int> destinationPath;
+		qint32 row = 0;
+		qint32 count = 0;
+		qint32 destinationRow = 0;
+		QVector<BookmarkNode> nodes;
+
+		stream >> operation >> path;
+
+		if (operation == InsertOperation || operation == RemoveOperation || operation == MoveOperation)
+		{
+			stream >> row >> count;
+		}
+
+		if (operation == MoveOperation)
+		{
+			stream >> destinationPath >> destinationRow;
+		}
+
+		if (operation == InsertOperation || operation == ChangeOperation)
+		{
+			qint32 nodesAmount = 0;
+
+			stream >> nodesAmount;
+
+			for (int i = 0; i < nodesAmount && stream.status() == QDataStream::Ok; ++i)
+			{
+				BookmarkNode node;
+
+				readNode(stream, node);
+
+				nodes.append(node);
+			}
+		}
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		QStandardItem *item = getItem(path);
+		bool isValid = (item != NULL);
+
+		if (isValid && operation == InsertOperation && row >= 0 && row <= item->rowCount())
+		{
+			item->insertRows(row, createItems(nodes));
+		}
+		else if (isValid && operation == RemoveOperation && row >= 0 && count > 0 && (row + count) <= item->rowCount())
+		{
+			item->removeRows(row, count);
+		}
+		else if (isValid && operation == ChangeOperation && !path.isEmpty() && nodes.count() == 1)
+		{
+			updateItem(item, nodes.first());
+		}
+		else if (isValid && operation == MoveOperation && row >= 0 && count > 0 && (row + count) <= item->rowCount() && getItem(destinationPath) && destinationRow >= 0 && destinationRow <= getItem(destinationPath)->rowCount())
+		{
+			QStandardItem *destinationItem = getItem(destinationPath);
+			QList<QList<QStandardItem*> > rows;
+
+			for (int i = 0; i < count; ++i)
+			{
+				rows.append(item->takeRow(row));
+			}
+
+			if (destinationItem == item && destinationRow > row)
+			{
+				destinationRow -= count;
+			}
+
+			for (int i = 0; i < rows.count(); ++i)
+			{
+				destinationItem->insertRow((destinationRow + i), rows.at(i));
+			}
+		}
+		else
+		{
+			isValid = false;
+		}
+
+		if (!isValid)
+		{
+			Console::addMessage(tr("Failed to replay bookmarks journal: inconsistent entry"), OtherMessageCategory, ErrorMessageLevel);
+
+			break;
+		}
+
+		++amount;
+	}
+
+	return amount;
+}
+
+void BookmarksManager::recordInsertion(const QModelIndex &parent, int first, int last)
+{
+	QVector<int> path;
+
+	if (!createPath(parent, path))
+	{
+		return;
+	}
+
+	QStandardItem *parentItem = m_model->itemFromIndex(parent);
+	QVector<BookmarkNode> nodes;
+
+	for (int i = first; i <= last; ++i)
+	{
+		createNodes(parentItem->child(i, 0), nodes, -1);
+	}
+
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << quint8(InsertOperation) << path << qint32(first) << qint32(last - first + 1) << qint32(nodes.count());
+
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		writeNode(stream, nodes.at(i));
+	}
+
+	writeJournal(record);
+}
+
+void BookmarksManager::recordRemoval(const QModelIndex &parent, int first, int last)
+{
+	QVector<int> path;
+
+	if (!createPath(parent, path))
+	{
+		return;
+	}
+
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << quint8(RemoveOperation) << path << qint32(first) << qint32(last - first + 1);
+
+	writeJournal(record);
+}
+
+void BookmarksManager::recordChange(QStandardItem *item)
+{
+	QVector<int> path;
+
+	if (!item || !createPath(item->index(), path) || path.isEmpty())
+	{
+		return;
+	}
+
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << quint8(ChangeOperation) << path << qint32(1);
+
+	writeNode(stream, createNode(item, -1));
+	writeJournal(record);
+}
+
+void BookmarksManager::recordMove(const QModelIndex &sourceParent, int sourceStart, int sourceEnd, const QModelIndex &destinationParent, int destinationRow)
+{
+	QVector<int> path;
+	QVector<int> destinationPath;
+
+	if (!createPath(sourceParent, path) || !createPath(destinationParent, destinationPath))
+	{
+		return;
+	}
+
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << quint8(MoveOperation) << path << qint32(sourceStart) << qint32(sourceEnd - sourceStart + 1) << destinationPath << qint32(destinationRow);
+
+	writeJournal(record);
+}
+
+BookmarksManager::BookmarksTree BookmarksManager::readBookmarks(const QString &path)
+{
+	BookmarksTree tree;
+	QFile file(path);
+
+	if (!file.open(QFile::ReadOnly | QFile::Text))
+	{
+		tree.errorString = file.errorString();
+
+		return tree;
+	}
+
+	QXmlStreamReader reader(&file);
+
+	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	{
+		while (reader.readNextStartElement())
+		{
+			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
+			{
+				readBookmark(&reader, tree.nodes, -1);
+			}
+			else
+			{
+				reader.skipCurrentElement();
+			}
+
+			if (reader.hasError())
+			{
+				tree.nodes.clear();
+				tree.error = reader.error();
+
+				return tree;
+			}
+		}
+	}
+
+	tree.isValid = true;
+
+	return tree;
+}
+
+void BookmarksManager::readBookmark(QXmlStreamReader *reader, QVector<BookmarkNode> &nodes, int parent)
+{
+	const int bookmark = nodes.count();
+
+	nodes.append(BookmarkNode());
+	nodes[bookmark].parent = parent;
 
 	if (reader->name() == QLatin1String("folder"))
 	{
-		bookmark = new BookmarksItem(BookmarksItem::FolderBookmark);
-		bookmark->setData(QDateTime::fromString(reader->attributes().value(QLatin1String("added")).toString(), Qt::ISODate), BookmarksModel::TimeAddedRole);
-		bookmark->setData(QDateTime::fromString(reader->attributes().value(QLatin1String("modified")).toString(), Qt::ISODate), BookmarksModel::TimeModifiedRole);
+		nodes[bookmark].type = BookmarksItem::FolderBookmark;
+		nodes[bookmark].timeAdded = QDateTime::fromString(reader->attributes().value(QLatin1String("added")).toString(), Qt::ISODate);
+		nodes[bookmark].timeModified = QDateTime::fromString(reader->attributes().value(QLatin1String("modified")).toString(), Qt::ISODate);
 
 		while (reader->readNext())
 		{
@@ -87,15 +542,15 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 			{
 				if (reader->name() == QLatin1String("title"))
 				{
-					bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::TitleRole);
+					nodes[bookmark].title = reader->readElementText().trimmed();
 				}
 				else if (reader->name() == QLatin1String("desc"))
 				{
-					bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::DescriptionRole);
+					nodes[bookmark].description = reader->readElementText().trimmed();
 				}
 				else if (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator"))
 				{
-					readBookmark(reader, bookmark);
+					readBookmark(reader, nodes, bookmark);
 				}
 				else if (reader->name() == QLatin1String("info"))
 				{
@@ -111,7 +566,7 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 									{
 										if (reader->name() == QLatin1String("keyword"))
 										{
-											bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::KeywordRole);
+											nodes[bookmark].keyword = reader->readElementText().trimmed();
 										}
 										else
 										{
@@ -152,10 +607,11 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 	}
 	else if (reader->name() == QLatin1String("bookmark"))
 	{
-		bookmark = new BookmarksItem(BookmarksItem::UrlBookmark, reader->attributes().value(QLatin1String("href")).toString());
-		bookmark->setData(QDateTime::fromString(reader->attributes().value(QLatin1String("added")).toString(), Qt::ISODate), BookmarksModel::TimeAddedRole);
-		bookmark->setData(QDateTime::fromString(reader->attributes().value(QLatin1String("modified")).toString(), Qt::ISODate), BookmarksModel::TimeModifiedRole);
-		bookmark->setData(QDateTime::fromString(reader->attributes().value(QLatin1String("visited")).toString(), Qt::ISODate), BookmarksModel::TimeVisitedRole);
+		nodes[bookmark].type = BookmarksItem::UrlBookmark;
+		nodes[bookmark].url = reader->attributes().value(QLatin1String("href")).toString();
+		nodes[bookmark].timeAdded = QDateTime::fromString(reader->attributes().value(QLatin1String("added")).toString(), Qt::ISODate);
+		nodes[bookmark].timeModified = QDateTime::fromString(reader->attributes().value(QLatin1String("modified")).toString(), Qt::ISODate);
+		nodes[bookmark].timeVisited = QDateTime::fromString(reader->attributes().value(QLatin1String("visited")).toString(), Qt::ISODate);
 
 		while (reader->readNext())
 		{
@@ -163,11 +619,11 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 			{
 				if (reader->name() == QLatin1String("title"))
 				{
-					bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::TitleRole);
+					nodes[bookmark].title = reader->readElementText().trimmed();
 				}
 				else if (reader->name() == QLatin1String("desc"))
 				{
-					bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::DescriptionRole);
+					nodes[bookmark].description = reader->readElementText().trimmed();
 				}
 				else if (reader->name() == QLatin1String("info"))
 				{
@@ -183,11 +639,11 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 									{
 										if (reader->name() == QLatin1String("keyword"))
 										{
-											bookmark->setData(reader->readElementText().trimmed(), BookmarksModel::KeywordRole);
+											nodes[bookmark].keyword = reader->readElementText().trimmed();
 										}
 										else if (reader->name() == QLatin1String("visits"))
 										{
-											bookmark->setData(reader->readElementText().toInt(), BookmarksModel::VisitsRole);
+											nodes[bookmark].visits = reader->readElementText().toInt();
 										}
 										else
 										{
@@ -228,56 +684,51 @@ void BookmarksManager::readBookmark(QXmlStreamReader *reader, BookmarksItem *par
 	}
 	else if (reader->name() == QLatin1String("separator"))
 	{
-		bookmark = new BookmarksItem(BookmarksItem::SeparatorBookmark);
+		nodes[bookmark].type = BookmarksItem::SeparatorBookmark;
 
 		reader->readNext();
 	}
-
-	parent->appendRow(bookmark);
 }
 
-void BookmarksManager::writeBookmark(QXmlStreamWriter *writer, QStandardItem *bookmark)
+void BookmarksManager::writeBookmark(QXmlStreamWriter *writer, const QVector<BookmarkNode> &nodes, const QVector<QVector<int> > &children, int bookmark)
 {
-	if (!bookmark)
-	{
-		return;
-	}
+	const BookmarkNode &node = nodes.at(bookmark);
 
-	switch (static_cast<BookmarksItem::BookmarkType>(bookmark->data(BookmarksModel::TypeRole).toInt()))
+	switch (static_cast<BookmarksItem::BookmarkType>(node.type))
 	{
 		case BookmarksItem::FolderBookmark:
 			writer->writeStartElement(QLatin1String("folder"));
 
-			if (bookmark->data(BookmarksModel::TimeAddedRole).toDateTime().isValid())
+			if (node.timeAdded.isValid())
 			{
-				writer->writeAttribute(QLatin1String("added"), bookmark->data(BookmarksModel::TimeAddedRole).toDateTime().toString(Qt::ISODate));
+				writer->writeAttribute(QLatin1String("added"), node.timeAdded.toString(Qt::ISODate));
 			}
 
-			if (bookmark->data(BookmarksModel::TimeModifiedRole).toDateTime().isValid())
+			if (node.timeModified.isValid())
 			{
-				writer->writeAttribute(QLatin1String("modified"), bookmark->data(BookmarksModel::TimeModifiedRole).toDateTime().toString(Qt::ISODate));
+				writer->writeAttribute(QLatin1String("modified"), node.timeModified.toString(Qt::ISODate));
 			}
 
-			writer->writeTextElement(QLatin1String("title"), bookmark->data(BookmarksModel::TitleRole).toString());
+			writer->writeTextElement(QLatin1String("title"), node.title);
 
-			if (!bookmark->data(BookmarksModel::DescriptionRole).toString().isEmpty())
+			if (!node.description.isEmpty())
 			{
-				writer->writeTextElement(QLatin1String("desc"), bookmark->data(BookmarksModel::DescriptionRole).toString());
+				writer->writeTextElement(QLatin1String("desc"), node.description);
 			}
 
-			if (!bookmark->data(BookmarksModel::KeywordRole).toString().isEmpty())
+			if (!node.keyword.isEmpty())
 			{
 				writer->writeStartElement(QLatin1String("info"));
 				writer->writeStartElement(QLatin1String("metadata"));
 				writer->writeAttribute(QLatin1String("owner"), QLatin1String("http://otter-browser.org/otter-xbel-bookmark"));
-				writer->writeTextElement(QLatin1String("keyword"), bookmark->data(BookmarksModel::KeywordRole).toString());
+				writer->writeTextElement(QLatin1String("keyword"), node.keyword);
 				writer->writeEndElement();
 				writer->writeEndElement();
 			}
 
-			for (int i = 0; i < bookmark->rowCount(); ++i)
+			for (int i = 0; i < children.at(bookmark).count(); ++i)
 			{
-				writeBookmark(writer, bookmark->child(i, 0));
+				writeBookmark(writer, nodes, children, children.at(bookmark).at(i));
 			}
 
 			writer->writeEndElement();
@@ -286,47 +737,47 @@ void BookmarksManager::writeBookmark(QXmlStreamWriter *writer, QStandardItem *bo
 		case BookmarksItem::UrlBookmark:
 			writer->writeStartElement(QLatin1String("bookmark"));
 
-			if (!bookmark->data(BookmarksModel::UrlRole).toString().isEmpty())
+			if (!node.url.isEmpty())
 			{
-				writer->writeAttribute(QLatin1String("href"), bookmark->data(BookmarksModel::UrlRole).toString());
+				writer->writeAttribute(QLatin1String("href"), node.url);
 			}
 
-			if (bookmark->data(BookmarksModel::TimeAddedRole).toDateTime().isValid())
+			if (node.timeAdded.isValid())
 			{
-				writer->writeAttribute(QLatin1String("added"), bookmark->data(BookmarksModel::TimeAddedRole).toDateTime().toString(Qt::ISODate));
+				writer->writeAttribute(QLatin1String("added"), node.timeAdded.toString(Qt::ISODate));
 			}
 
-			if (bookmark->data(BookmarksModel::TimeModifiedRole).toDateTime().isValid())
+			if (node.timeModified.isValid())
 			{
-				writer->writeAttribute(QLatin1String("modified"), bookmark->data(BookmarksModel::TimeModifiedRole).toDateTime().toString(Qt::ISODate));
+				writer->writeAttribute(QLatin1String("modified"), node.timeModified.toString(Qt::ISODate));
 			}
 
-			if (bookmark->data(BookmarksModel::TimeVisitedRole).toDateTime().isValid())
+			if (node.timeVisited.isValid())
 			{
-				writer->writeAttribute(QLatin1String("visited"), bookmark->data(BookmarksModel::TimeVisitedRole).toDateTime().toString(Qt::ISODate));
+				writer->writeAttribute(QLatin1String("visited"), node.timeVisited.toString(Qt::ISODate));
 			}
 
-			writer->writeTextElement(QLatin1String("title"), bookmark->data(BookmarksModel::TitleRole).toString());
+			writer->writeTextElement(QLatin1String("title"), node.title);
 
-			if (!bookmark->data(BookmarksModel::DescriptionRole).toString().isEmpty())
+			if (!node.description.isEmpty())
 			{
-				writer->writeTextElement(QLatin1String("desc"), bookmark->data(BookmarksModel::DescriptionRole).toString());
+				writer->writeTextElement(QLatin1String("desc"), node.description);
 			}
 
-			if (!bookmark->data(BookmarksModel::KeywordRole).toString().isEmpty() || bookmark->data(BookmarksModel::VisitsRole).toInt() > 0)
+			if (!node.keyword.isEmpty() || node.visits > 0)
 			{
 				writer->writeStartElement(QLatin1String("info"));
 				writer->writeStartElement(QLatin1String("metadata"));
 				writer->writeAttribute(QLatin1String("owner"), QLatin1String("http://otter-browser.org/otter-xbel-bookmark"));
 
-				if (!bookmark->data(BookmarksModel::KeywordRole).toString().isEmpty())
+				if (!node.keyword.isEmpty())
 				{
-					writer->writeTextElement(QLatin1String("keyword"), bookmark->data(BookmarksModel::KeywordRole).toString());
+					writer->writeTextElement(QLatin1String("keyword"), node.keyword);
 				}
 
-				if (bookmark->data(BookmarksModel::VisitsRole).toInt() > 0)
+				if (node.visits > 0)
 				{
-					writer->writeTextElement(QLatin1String("visits"), QString::number(bookmark->data(BookmarksModel::VisitsRole).toInt()));
+					writer->writeTextElement(QLatin1String("visits"), QString::number(node.visits));
 				}
 
 				writer->writeEndElement();
@@ -343,6 +794,62 @@ void BookmarksManager::writeBookmark(QXmlStreamWriter *writer, QStandardItem *bo
 	}
 }
 
+void BookmarksManager::readNode(QDataStream &stream, BookmarkNode &node)
+{
+	qint32 type = 0;
+	qint32 parent = -1;
+	qint32 visits = 0;
+
+	stream >> type >> parent >> node.url >> node.title >> node.description >> node.keyword >> node.timeAdded >> node.timeModified >> node.timeVisited >> visits;
+
+	node.type = type;
+	node.parent = parent;
+	node.visits = visits;
+}
+
+void BookmarksManager::writeNode(QDataStream &stream, const BookmarkNode &node)
+{
+	stream << qint32(node.type) << qint32(node.parent) << node.url << node.title << node.description << node.keyword << node.timeAdded << node.timeModified << node.timeVisited << qint32(node.visits);
+}
+
+void BookmarksManager::createNodes(QStandardItem *item, QVector<BookmarkNode> &nodes, int parent)
+{
+	if (!item)
+	{
+		return;
+	}
+
+	const int bookmark = nodes.count();
+
+	nodes.append(createNode(item, parent));
+
+	for (int i = 0; i < item->rowCount(); ++i)
+	{
+		createNodes(item->child(i, 0), nodes, bookmark);
+	}
+}
+
+void BookmarksManager::updateItem(QStandardItem *item, const BookmarkNode &node)
+{
+	if (node.type == BookmarksItem::SeparatorBookmark)
+	{
+		return;
+	}
+
+	if (node.type == BookmarksItem::UrlBookmark)
+	{
+		item->setData(QUrl(node.url), BookmarksModel::UrlRole);
+		item->setData(node.timeVisited, BookmarksModel::TimeVisitedRole);
+		item->setData(node.visits, BookmarksModel::VisitsRole);
+	}
+
+	item->setData(node.title, BookmarksModel::TitleRole);
+	item->setData(node.description, BookmarksModel::DescriptionRole);
+	item->setData(node.keyword, BookmarksModel::KeywordRole);
+	item->setData(node.timeAdded, BookmarksModel::TimeAddedRole);
+	item->setData(node.timeModified, BookmarksModel::TimeModifiedRole);
+}
+
 void BookmarksManager::updateVisits(const QString &url)
 {
 	if (BookmarksItem::hasBookmark(url))
@@ -372,66 +879,130 @@ void BookmarksManager::deleteBookmark(const QString &url)
 	}
 }
 
-BookmarksManager* BookmarksManager::getInstance()
+BookmarksManager::BookmarkNode BookmarksManager::createNode(QStandardItem *item, int parent)
 {
-	return m_instance;
+	const BookmarksStore &store = BookmarksItem::m_store;
+	const int bookmark = static_cast<BookmarksItem*>(item)->m_identifier;
+	BookmarkNode node;
+	node.type = store.getType(bookmark);
+	node.parent = parent;
+	node.url = store.getText(bookmark, BookmarksModel::UrlRole);
+	node.title = store.getText(bookmark, BookmarksModel::TitleRole);
+	node.description = store.getText(bookmark, BookmarksModel::DescriptionRole);
+	node.keyword = store.getText(bookmark, BookmarksModel::KeywordRole);
+	node.timeAdded = store.getTime(bookmark, BookmarksModel::TimeAddedRole);
+	node.timeModified = store.getTime(bookmark, BookmarksModel::TimeModifiedRole);
+	node.timeVisited = store.getTime(bookmark, BookmarksModel::TimeVisitedRole);
+	node.visits = store.getVisits(bookmark);
+
+	return node;
 }
 
-BookmarksModel* BookmarksManager::getModel()
+QStandardItem* BookmarksManager::getItem(const QVector<int> &path)
 {
-	if (!m_model && m_instance)
+	QStandardItem *item = m_model->getRootItem();
+
+	for (int i = 0; i < path.count(); ++i)
 	{
-		QFile file(SessionsManager::getProfilePath() + QLatin1String("/bookmarks.xbel"));
+		if (!item || path.at(i) < 0 || path.at(i) >= item->rowCount())
+		{
+			return NULL;
+		}
 
-		m_model = new BookmarksModel(m_instance);
+		item = item->child(path.at(i), 0);
+	}
+
+	return item;
+}
+
+QList<QStandardItem*> BookmarksManager::createItems(const QVector<BookmarkNode> &nodes)
+{
+	QVector<BookmarksItem*> items;
+	items.reserve(nodes.count());
+
+	QList<QStandardItem*> topLevelItems;
+
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		const BookmarkNode &node = nodes.at(i);
+		BookmarksItem *bookmark = new BookmarksItem(static_cast<BookmarksItem::BookmarkType>(node.type), QUrl(node.url));
 
-		if (!file.exists())
+		if (node.type != BookmarksItem::SeparatorBookmark)
 		{
-			connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), m_instance, SLOT(scheduleSave()));
+			bookmark->setData(node.timeAdded, BookmarksModel::TimeAddedRole);
+			bookmark->setData(node.timeModified, BookmarksModel::TimeModifiedRole);
+
+			if (!node.title.isEmpty())
+			{
+				bookmark->setData(node.title, BookmarksModel::TitleRole);
+			}
+
+			if (!node.description.isEmpty())
+			{
+				bookmark->setData(node.description, BookmarksModel::DescriptionRole);
+			}
 
-			return m_model;
+			if (!node.keyword.isEmpty())
+			{
+				bookmark->setData(node.keyword, BookmarksModel::KeywordRole);
+			}
 		}
 
-		if (!file.open(QFile::ReadOnly | QFile::Text))
+		if (node.type == BookmarksItem::UrlBookmark)
 		{
-			Console::addMessage(tr("Failed to open bookmarks file: %0").arg(file.errorString()), OtherMessageCategory, ErrorMessageLevel);
+			bookmark->setData(node.timeVisited, BookmarksModel::TimeVisitedRole);
 
-			return m_model;
+			if (node.visits > 0)
+			{
+				bookmark->setData(node.visits, BookmarksModel::VisitsRole);
+			}
 		}
 
-		QXmlStreamReader reader(file.readAll());
+		items.append(bookmark);
 
-		if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+		if (node.parent < 0 || node.parent >= i)
 		{
-			while (reader.readNextStartElement())
-			{
-				if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
-				{
-					readBookmark(&reader, m_model->getRootItem());
-				}
-				else
-				{
-					reader.skipCurrentElement();
-				}
+			topLevelItems.append(bookmark);
+		}
+		else
+		{
+			items.at(node.parent)->appendRow(bookmark);
+		}
+	}
 
-				if (reader.hasError())
-				{
-					m_model->clear();
+	return topLevelItems;
+}
 
-					QMessageBox::warning(NULL, tr("Error"), tr("Failed to parse bookmarks file. No bookmarks were loaded."), QMessageBox::Close);
-					Console::addMessage(tr("Failed to load bookmarks file properly, QXmlStreamReader error code: %1").arg(reader.error()), OtherMessageCategory, ErrorMessageLevel);
+QVector<BookmarksManager::BookmarkNode> BookmarksManager::createSnapshot()
+{
+	QVector<BookmarkNode> nodes;
+	BookmarksItem *rootItem = m_model->getRootItem();
 
-					return m_model;
-				}
-			}
-		}
+	for (int i = 0; i < rootItem->rowCount(); ++i)
+	{
+		createNodes(rootItem->child(i, 0), nodes, -1);
+	}
 
-		connect(m_model, SIGNAL(itemChanged(QStandardItem*)), m_instance, SLOT(scheduleSave()));
-		connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), m_instance, SLOT(scheduleSave()));
-		connect(m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)), m_instance, SLOT(scheduleSave()));
-		connect(m_model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), m_instance, SLOT(scheduleSave()));
+	return nodes;
+}
 
-		emit m_instance->modelModified();
+QString BookmarksManager::getJournalPath(bool isCompacting)
+{
+	return SessionsManager::getProfilePath() + (isCompacting ? QLatin1String("/bookmarks.xbel.journal.old") : QLatin1String("/bookmarks.xbel.journal"));
+}
+
+BookmarksManager* BookmarksManager::getInstance()
+{
+	return m_instance;
+}
+
+BookmarksModel* BookmarksManager::getModel()
+{
+	if (!m_model && m_instance)
+	{
+		m_model = new BookmarksModel(m_instance);
+
+		m_instance->load();
 	}
 
 	return m_model;
@@ -487,15 +1058,61 @@ bool BookmarksManager::hasKeyword(const QString &keyword)
 	return BookmarksItem::hasKeyword(keyword);
 }
 
+bool BookmarksManager::createPath(const QModelIndex &index, QVector<int> &path)
+{
+	QModelIndex currentIndex = index;
+
+	while (currentIndex.isValid())
+	{
+		path.prepend(currentIndex.row());
+
+		currentIndex = currentIndex.parent();
+	}
+
+	if (path.isEmpty() || path.first() != 0)
+	{
+		return false;
+	}
+
+	path.remove(0);
+
+	return true;
+}
+
 bool BookmarksManager::save(const QString &path)
 {
-	QFile file(path.isEmpty() ? SessionsManager::getProfilePath() + QLatin1String("/bookmarks.xbel") : path);
+	if (!m_model)
+	{
+		return false;
+	}
+
+	return writeBookmarks((path.isEmpty() ? SessionsManager::getProfilePath() + QLatin1String("/bookmarks.xbel") : path), createSnapshot());
+}
 
-	if (!file.open(QFile::WriteOnly))
+bool BookmarksManager::writeBookmarks(const QString &path, const QVector<BookmarkNode> &nodes, const QString &journalPath)
+{
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
 	{
 		return false;
 	}
 
+	QVector<QVector<int> > children(nodes.count());
+	QVector<int> topLevelNodes;
+
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		if (nodes.at(i).parent < 0)
+		{
+			topLevelNodes.append(i);
+		}
+		else
+		{
+			children[nodes.at(i).parent].append(i);
+		}
+	}
+
 	QXmlStreamWriter writer(&file);
 	writer.setAutoFormatting(true);
 	writer.setAutoFormattingIndent(-1);
@@ -504,13 +1121,23 @@ bool BookmarksManager::save(const QString &path)
 	writer.writeStartElement(QLatin1String("xbel"));
 	writer.writeAttribute(QLatin1String("version"), QLatin1String("1.0"));
 
-	for (int i = 0; i < m_model->getRootItem()->rowCount(); ++i)
+	for (int i = 0; i < topLevelNodes.count(); ++i)
 	{
-		writeBookmark(&writer, m_model->getRootItem()->child(i, 0));
+		writeBookmark(&writer, nodes, children, topLevelNodes.at(i));
 	}
 
 	writer.writeEndDocument();
 
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	if (!journalPath.isEmpty())
+	{
+		QFile::remove(journalPath);
+	}
+
 	return true;
 }
 
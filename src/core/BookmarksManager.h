@@ -21,7 +21,10 @@
 #ifndef OTTER_BOOKMARKSMANAGER_H
 #define OTTER_BOOKMARKSMANAGER_H
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
 #include <QtGui/QStandardItemModel>
@@ -50,17 +53,79 @@ public:
 	static bool save(const QString &path = QString());
 
 protected:
+	enum JournalOperation
+	{
+		UnknownOperation = 0,
+		InsertOperation = 1,
+		RemoveOperation = 2,
+		ChangeOperation = 3,
+		MoveOperation = 4
+	};
+
+	struct BookmarkNode
+	{
+		QString url;
+		QString title;
+		QString description;
+		QString keyword;
+		QDateTime timeAdded;
+		QDateTime timeModified;
+		QDateTime timeVisited;
+		int type;
+		int parent;
+		int visits;
+
+		BookmarkNode() : type(0), parent(-1), visits(0) {}
+	};
+
+	struct BookmarksTree
+	{
+		QVector<BookmarkNode> nodes;
+		QString errorString;
+		QXmlStreamReader::Error error;
+		bool isValid;
+
+		BookmarksTree() : error(QXmlStreamReader::NoError), isValid(false) {}
+	};
+
 	explicit BookmarksManager(QObject *parent = NULL);
 
 	void timerEvent(QTimerEvent *event);
-	static void readBookmark(QXmlStreamReader *reader, BookmarksItem *parent);
-	static void writeBookmark(QXmlStreamWriter *writer, QStandardItem *bookmark);
+	void load();
+	void watchModel();
+	void compact();
+	void writeJournal(const QByteArray &record);
+	int replayJournal(const QString &path);
+	static void readBookmark(QXmlStreamReader *reader, QVector<BookmarkNode> &nodes, int parent);
+	static void writeBookmark(QXmlStreamWriter *writer, const QVector<BookmarkNode> &nodes, const QVector<QVector<int> > &children, int bookmark);
+	static void readNode(QDataStream &stream, BookmarkNode &node);
+	static void writeNode(QDataStream &stream, const BookmarkNode &node);
+	static void createNodes(QStandardItem *item, QVector<BookmarkNode> &nodes, int parent);
+	static BookmarkNode createNode(QStandardItem *item, int parent);
+	static void updateItem(QStandardItem *item, const BookmarkNode &node);
+	static QStandardItem* getItem(const QVector<int> &path);
+	static QList<QStandardItem*> createItems(const QVector<BookmarkNode> &nodes);
+	static QVector<BookmarkNode> createSnapshot();
+	static BookmarksTree readBookmarks(const QString &path);
+	static QString getJournalPath(bool isCompacting = false);
+	static bool createPath(const QModelIndex &index, QVector<int> &path);
+	static bool writeBookmarks(const QString &path, const QVector<BookmarkNode> &nodes, const QString &journalPath = QString());
 
 protected slots:
 	void scheduleSave();
+	void loadingFinished();
+	void compactionFinished();
+	void recordInsertion(const QModelIndex &parent, int first, int last);
+	void recordRemoval(const QModelIndex &parent, int first, int last);
+	void recordChange(QStandardItem *item);
+	void recordMove(const QModelIndex &sourceParent, int sourceStart, int sourceEnd, const QModelIndex &destinationParent, int destinationRow);
 
 private:
+	QFutureWatcher<BookmarksTree> *m_loadingWatcher;
+	QFutureWatcher<bool> *m_compactionWatcher;
+	QFile *m_journal;
 	int m_saveTimer;
+	bool m_needsCompaction;
 
 	static BookmarksManager *m_instance;
 	static BookmarksModel* m_model;
@@ -18,19 +18,21 @@
 **************************************************************************/
 
 #include "BookmarksModel.h"
-#include "AddonsManager.h"
+#include "FaviconsCache.h"
 #include "Utils.h"
-#include "WebBackend.h"
 
 #include <QtCore/QMimeData>
 
 namespace Otter
 {
 
-QHash<QString, QList<BookmarksItem*> > BookmarksItem::m_urls;
+BookmarksStore BookmarksItem::m_store;
+QHash<int, QList<BookmarksItem*> > BookmarksItem::m_urls;
+QHash<QString, QList<BookmarksItem*> > BookmarksItem::m_hosts;
 QHash<QString, BookmarksItem*> BookmarksItem::m_keywords;
 
-BookmarksItem::BookmarksItem(BookmarkType type, const QUrl &url, const QString &title) : QStandardItem()
+BookmarksItem::BookmarksItem(BookmarkType type, const QUrl &url, const QString &title) : QStandardItem(),
+	m_identifier(m_store.createBookmark())
 {
 	setData(type, BookmarksModel::TypeRole);
 	setData(url, BookmarksModel::UrlRole);
@@ -55,35 +57,62 @@ BookmarksItem::BookmarksItem(BookmarkType type, const QUrl &url, const QString &
 
 BookmarksItem::~BookmarksItem()
 {
-	if (!data(BookmarksModel::UrlRole).toString().isEmpty())
+	const int url = m_store.getUrlIdentifier(m_identifier);
+
+	if (url >= 0 && m_urls.contains(url))
 	{
-		const QString url = data(BookmarksModel::UrlRole).toUrl().toString();
+		m_urls[url].removeAll(this);
 
-		if (m_urls.contains(url))
+		if (m_urls[url].isEmpty())
 		{
-			m_urls[url].removeAll(this);
+			m_urls.remove(url);
+		}
 
-			if (m_urls[url].isEmpty())
-			{
-				m_urls.remove(url);
-			}
+		const QString host = FaviconsCache::getKey(QUrl(m_store.getString(url)));
+
+		m_hosts[host].removeAll(this);
+
+		if (m_hosts[host].isEmpty())
+		{
+			m_hosts.remove(host);
 		}
 	}
 
-	if (!data(BookmarksModel::KeywordRole).toString().isEmpty() && m_keywords.contains(data(BookmarksModel::UrlRole).toString()))
+	const QString keyword = m_store.getData(m_identifier, BookmarksModel::KeywordRole).toString();
+
+	if (!keyword.isEmpty() && m_keywords.value(keyword) == this)
 	{
-		m_keywords.remove(data(BookmarksModel::UrlRole).toString());
+		m_keywords.remove(keyword);
 	}
+
+	m_store.removeBookmark(m_identifier);
 }
 
 void BookmarksItem::setData(const QVariant &value, int role)
 {
-	if (role == BookmarksModel::UrlRole && value.toUrl() != data(BookmarksModel::UrlRole).toUrl())
+	if (role == Qt::EditRole)
 	{
-		const QString oldUrl = data(BookmarksModel::UrlRole).toUrl().toString();
-		const QString newUrl = value.toUrl().toString();
+		role = Qt::DisplayRole;
+	}
+
+	if (!BookmarksStore::isStored(role))
+	{
+		QStandardItem::setData(value, role);
+
+		return;
+	}
 
-		if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
+	if (role == BookmarksModel::UrlRole)
+	{
+		const int oldUrl = m_store.getUrlIdentifier(m_identifier);
+		const QString oldUrlString = m_store.getString(oldUrl);
+
+		if (!m_store.setData(m_identifier, role, value))
+		{
+			return;
+		}
+
+		if (oldUrl >= 0 && m_urls.contains(oldUrl))
 		{
 			m_urls[oldUrl].removeAll(this);
 
@@ -91,21 +120,41 @@ void BookmarksItem::setData(const QVariant &value, int role)
 			{
 				m_urls.remove(oldUrl);
 			}
-		}
 
-		if (!newUrl.isEmpty())
-		{
-			if (!m_urls.contains(newUrl))
+			const QString oldHost = FaviconsCache::getKey(QUrl(oldUrlString));
+
+			m_hosts[oldHost].removeAll(this);
+
+			if (m_hosts[oldHost].isEmpty())
 			{
-				m_urls[newUrl] = QList<BookmarksItem*>();
+				m_hosts.remove(oldHost);
 			}
+		}
 
+		const int newUrl = m_store.getUrlIdentifier(m_identifier);
+
+		if (newUrl >= 0)
+		{
 			m_urls[newUrl].append(this);
+			m_hosts[FaviconsCache::getKey(QUrl(m_store.getString(newUrl)))].append(this);
+		}
+
+		BookmarksModel *bookmarksModel = qobject_cast<BookmarksModel*>(model());
+
+		if (bookmarksModel && !oldUrlString.isEmpty())
+		{
+			emit bookmarksModel->bookmarkRemoved(QUrl(oldUrlString));
 		}
 	}
-	else if (role == BookmarksModel::KeywordRole && value.toString() != data(BookmarksModel::KeywordRole).toString())
+	else if (role == BookmarksModel::KeywordRole)
 	{
-		const QString oldKeyword = data(BookmarksModel::KeywordRole).toString();
+		const QString oldKeyword = m_store.getData(m_identifier, role).toString();
+
+		if (!m_store.setData(m_identifier, role, value))
+		{
+			return;
+		}
+
 		const QString newKeyword = value.toString();
 
 		if (!oldKeyword.isEmpty() && m_keywords.contains(oldKeyword))
@@ -118,8 +167,12 @@ void BookmarksItem::setData(const QVariant &value, int role)
 			m_keywords[newKeyword] = this;
 		}
 	}
+	else if (!m_store.setData(m_identifier, role, value))
+	{
+		return;
+	}
 
-	QStandardItem::setData(value, role);
+	emitDataChanged();
 }
 
 QStandardItem* BookmarksItem::clone() const
@@ -147,12 +200,7 @@ BookmarksItem* BookmarksItem::getBookmark(const QString &keyword)
 
 QList<BookmarksItem*> BookmarksItem::getBookmarks(const QString &url)
 {
-	if (m_urls.contains(url))
-	{
-		return m_urls[url];
-	}
-
-	return QList<BookmarksItem*>();
+	return m_urls.value(m_store.findString(url));
 }
 
 QStringList BookmarksItem::getKeywords()
@@ -162,7 +210,15 @@ QStringList BookmarksItem::getKeywords()
 
 QStringList BookmarksItem::getUrls()
 {
-	return m_urls.keys();
+	QStringList urls;
+	urls.reserve(m_urls.count());
+
+	for (QHash<int, QList<BookmarksItem*> >::const_iterator iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		urls.append(m_store.getString(iterator.key()));
+	}
+
+	return urls;
 }
 
 QVariant BookmarksItem::data(int role) const
@@ -181,7 +237,7 @@ QVariant BookmarksItem::data(int role) const
 		}
 		else if (type == UrlBookmark)
 		{
-			return AddonsManager::getWebBackend()->getIconForUrl(data(BookmarksModel::UrlRole).toUrl());
+			return FaviconsCache::getIcon(data(BookmarksModel::UrlRole).toUrl());
 		}
 
 		return QVariant();
@@ -192,12 +248,22 @@ QVariant BookmarksItem::data(int role) const
 		return QLatin1String("separator");
 	}
 
+	if (role == Qt::EditRole)
+	{
+		role = Qt::DisplayRole;
+	}
+
+	if (BookmarksStore::isStored(role))
+	{
+		return m_store.getData(m_identifier, role);
+	}
+
 	return QStandardItem::data(role);
 }
 
 bool BookmarksItem::hasBookmark(const QString &url)
 {
-	return m_urls.contains(QUrl(url).toString());
+	return m_urls.contains(m_store.findString(QUrl(url).toString()));
 }
 
 bool BookmarksItem::hasKeyword(const QString &keyword)
@@ -207,7 +273,7 @@ bool BookmarksItem::hasKeyword(const QString &keyword)
 
 bool BookmarksItem::hasUrl(const QString &url)
 {
-	return m_urls.contains(url);
+	return m_urls.contains(m_store.findString(url));
 }
 
 BookmarksModel::BookmarksModel(QObject *parent) : QStandardItemModel(parent)
@@ -215,6 +281,194 @@ BookmarksModel::BookmarksModel(QObject *parent) : QStandardItemModel(parent)
 	appendRow(new BookmarksItem(BookmarksItem::RootBookmark, QUrl(), tr("Bookmarks")));
 	appendRow(new BookmarksItem(BookmarksItem::TrashBookmark, QUrl(), tr("Trash")));
 	setItemPrototype(new BookmarksItem(BookmarksItem::UnknownBookmark));
+
+	connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(notifyItemChanged(QStandardItem*)));
+	connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(notifyRowsInserted(QModelIndex,int,int)));
+	connect(this, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(notifyRowsAboutToBeRemoved(QModelIndex,int,int)));
+
+	if (FaviconsCache::getInstance())
+	{
+		connect(FaviconsCache::getInstance(), SIGNAL(iconsChanged(QStringList)), this, SLOT(updateIcons(QStringList)));
+	}
+}
+
+void BookmarksModel::emitBookmarksAdded(QStandardItem *branch)
+{
+	if (!branch)
+	{
+		return;
+	}
+
+	if (static_cast<BookmarksItem::BookmarkType>(branch->data(TypeRole).toInt()) == BookmarksItem::UrlBookmark)
+	{
+		emit bookmarkAdded(dynamic_cast<BookmarksItem*>(branch));
+
+		return;
+	}
+
+	for (int i = 0; i < branch->rowCount(); ++i)
+	{
+		emitBookmarksAdded(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::emitBookmarksRemoved(QStandardItem *branch)
+{
+	if (!branch)
+	{
+		return;
+	}
+
+	if (static_cast<BookmarksItem::BookmarkType>(branch->data(TypeRole).toInt()) == BookmarksItem::UrlBookmark)
+	{
+		emit bookmarkRemoved(branch->data(UrlRole).toUrl());
+
+		return;
+	}
+
+	for (int i = 0; i < branch->rowCount(); ++i)
+	{
+		emitBookmarksRemoved(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::indexBookmarks(QStandardItem *branch)
+{
+	if (!branch)
+	{
+		return;
+	}
+
+	indexBookmark(branch);
+
+	for (int i = 0; i < branch->rowCount(); ++i)
+	{
+		indexBookmarks(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::unindexBookmarks(QStandardItem *branch)
+{
+	if (!branch)
+	{
+		return;
+	}
+
+	unindexBookmark(branch);
+
+	for (int i = 0; i < branch->rowCount(); ++i)
+	{
+		unindexBookmarks(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::indexBookmark(QStandardItem *bookmark)
+{
+	const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(bookmark->data(TypeRole).toInt());
+
+	if (type != BookmarksItem::FolderBookmark && type != BookmarksItem::UrlBookmark)
+	{
+		return;
+	}
+
+	const QStringList tokens = createTokens(bookmark->data(UrlRole).toString() + QLatin1Char(' ') + bookmark->data(TitleRole).toString() + QLatin1Char(' ') + bookmark->data(DescriptionRole).toString() + QLatin1Char(' ') + bookmark->data(KeywordRole).toString());
+	QSet<QString> suffixes;
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		for (int j = 0; j < tokens.at(i).length(); ++j)
+		{
+			suffixes.insert(tokens.at(i).mid(j));
+		}
+	}
+
+	QSet<QString>::const_iterator iterator;
+
+	for (iterator = suffixes.constBegin(); iterator != suffixes.constEnd(); ++iterator)
+	{
+		m_tokens[*iterator].insert(bookmark);
+	}
+
+	m_bookmarkTokens[bookmark] = suffixes.toList();
+}
+
+void BookmarksModel::unindexBookmark(QStandardItem *bookmark)
+{
+	if (!m_bookmarkTokens.contains(bookmark))
+	{
+		return;
+	}
+
+	const QStringList tokens = m_bookmarkTokens.take(bookmark);
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		QMap<QString, QSet<QStandardItem*> >::iterator iterator = m_tokens.find(tokens.at(i));
+
+		if (iterator != m_tokens.end())
+		{
+			iterator.value().remove(bookmark);
+
+			if (iterator.value().isEmpty())
+			{
+				m_tokens.erase(iterator);
+			}
+		}
+	}
+}
+
+void BookmarksModel::notifyItemChanged(QStandardItem *item)
+{
+	if (item)
+	{
+		unindexBookmark(item);
+		indexBookmark(item);
+	}
+
+	if (item && static_cast<BookmarksItem::BookmarkType>(item->data(TypeRole).toInt()) == BookmarksItem::UrlBookmark)
+	{
+		emit bookmarkModified(dynamic_cast<BookmarksItem*>(item));
+	}
+}
+
+void BookmarksModel::notifyRowsInserted(const QModelIndex &parent, int first, int last)
+{
+	QStandardItem *branch = (parent.isValid() ? itemFromIndex(parent) : invisibleRootItem());
+
+	for (int i = first; i <= last; ++i)
+	{
+		indexBookmarks(branch->child(i, 0));
+		emitBookmarksAdded(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::notifyRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+	QStandardItem *branch = (parent.isValid() ? itemFromIndex(parent) : invisibleRootItem());
+
+	for (int i = first; i <= last; ++i)
+	{
+		unindexBookmarks(branch->child(i, 0));
+		emitBookmarksRemoved(branch->child(i, 0));
+	}
+}
+
+void BookmarksModel::updateIcons(const QStringList &keys)
+{
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const QList<BookmarksItem*> bookmarks = BookmarksItem::m_hosts.value(keys.at(i));
+
+		for (int j = 0; j < bookmarks.count(); ++j)
+		{
+			if (bookmarks.at(j)->model() == this)
+			{
+				const QModelIndex index = bookmarks.at(j)->index();
+
+				emit dataChanged(index, index, QVector<int>(1, Qt::DecorationRole));
+			}
+		}
+	}
 }
 
 QMimeData* BookmarksModel::mimeData(const QModelIndexList &indexes) const
@@ -289,6 +543,94 @@ QList<QStandardItem*> BookmarksModel::findUrls(const QString &url, QStandardItem
 	return items;
 }
 
+QList<QStandardItem*> BookmarksModel::findBookmarks(const QString &filter) const
+{
+	const QStringList tokens = createTokens(filter);
+	QList<QStandardItem*> candidates;
+
+	if (tokens.isEmpty())
+	{
+		candidates = m_bookmarkTokens.keys();
+	}
+	else
+	{
+		QSet<QStandardItem*> matches;
+
+		for (int i = 0; i < tokens.count(); ++i)
+		{
+			QSet<QStandardItem*> tokenMatches;
+
+			for (QMap<QString, QSet<QStandardItem*> >::const_iterator iterator = m_tokens.lowerBound(tokens.at(i)); iterator != m_tokens.constEnd() && iterator.key().startsWith(tokens.at(i)); ++iterator)
+			{
+				tokenMatches.unite(iterator.value());
+			}
+
+			if (i == 0)
+			{
+				matches = tokenMatches;
+			}
+			else
+			{
+				matches.intersect(tokenMatches);
+			}
+
+			if (matches.isEmpty())
+			{
+				break;
+			}
+		}
+
+		candidates = matches.toList();
+	}
+
+	QList<QStandardItem*> bookmarks;
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		if (matchesFilter(candidates.at(i), filter))
+		{
+			bookmarks.append(candidates.at(i));
+		}
+	}
+
+	return bookmarks;
+}
+
+QStringList BookmarksModel::createTokens(const QString &text)
+{
+	const QString normalizedText = text.toLower();
+	QStringList tokens;
+	int start = -1;
+
+	for (int i = 0; i <= normalizedText.length(); ++i)
+	{
+		const bool isWordCharacter = (i < normalizedText.length() && normalizedText.at(i).isLetterOrNumber());
+
+		if (isWordCharacter && start < 0)
+		{
+			start = i;
+		}
+		else if (!isWordCharacter && start >= 0)
+		{
+			const QString token = normalizedText.mid(start, (i - start));
+
+			if (!tokens.contains(token))
+			{
+				tokens.append(token);
+			}
+
+			start = -1;
+		}
+	}
+
+	return tokens;
+}
+
+bool BookmarksModel::matchesFilter(QStandardItem *bookmark, const QString &filter)
+{
+	return BookmarksItem::m_store.containsText(static_cast<BookmarksItem*>(bookmark)->m_identifier, filter);
+}
+
 bool BookmarksModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent)
 {
 	const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(parent.data(BookmarksModel::TypeRole).toInt());
@@ -21,7 +21,9 @@
 #define OTTER_BOOKMARKSMODEL_H
 
 #include "BookmarksManager.h"
+#include "BookmarksStore.h"
 
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 #include <QtGui/QStandardItemModel>
 
@@ -58,10 +60,15 @@ protected:
 	static bool hasUrl(const QString &url);
 
 private:
-	static QHash<QString, QList<BookmarksItem*> > m_urls;
+	int m_identifier;
+
+	static BookmarksStore m_store;
+	static QHash<int, QList<BookmarksItem*> > m_urls;
+	static QHash<QString, QList<BookmarksItem*> > m_hosts;
 	static QHash<QString, BookmarksItem*> m_keywords;
 
 	friend class BookmarksManager;
+	friend class BookmarksModel;
 	friend class BookmarkPropertiesDialog;
 };
 
@@ -90,7 +97,33 @@ public:
 	BookmarksItem* getTrashItem();
 	QStringList mimeTypes() const;
 	QList<QStandardItem*> findUrls(const QString &url, QStandardItem *branch = NULL);
+	QList<QStandardItem*> findBookmarks(const QString &filter) const;
 	bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent);
+
+protected:
+	void emitBookmarksAdded(QStandardItem *branch);
+	void emitBookmarksRemoved(QStandardItem *branch);
+	void indexBookmarks(QStandardItem *branch);
+	void unindexBookmarks(QStandardItem *branch);
+	void indexBookmark(QStandardItem *bookmark);
+	void unindexBookmark(QStandardItem *bookmark);
+	static QStringList createTokens(const QString &text);
+	static bool matchesFilter(QStandardItem *bookmark, const QString &filter);
+
+protected slots:
+	void notifyItemChanged(QStandardItem *item);
+	void notifyRowsInserted(const QModelIndex &parent, int first, int last);
+	void notifyRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+	void updateIcons(const QStringList &keys);
+
+private:
+	QMap<QString, QSet<QStandardItem*> > m_tokens;
+	QHash<QStandardItem*, QStringList> m_bookmarkTokens;
+
+signals:
+	void bookmarkAdded(BookmarksItem *bookmark);
+	void bookmarkModified(BookmarksItem *bookmark);
+	void bookmarkRemoved(const QUrl &url);
 };
 
 }
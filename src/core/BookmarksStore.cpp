@@ -0,0 +1,397 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BookmarksStore.h"
+#include "BookmarksModel.h"
+
+#include <QtCore/QUrl>
+
+namespace Otter
+{
+
+BookmarksStore::BookmarksStore()
+{
+}
+
+int BookmarksStore::createBookmark()
+{
+	if (!m_freeBookmarks.isEmpty())
+	{
+		return m_freeBookmarks.takeLast();
+	}
+
+	m_types.append(BookmarksItem::UnknownBookmark);
+	m_urls.append(-1);
+	m_titles.append(-1);
+	m_descriptions.append(-1);
+	m_keywords.append(-1);
+	m_timesAdded.append(0);
+	m_timesModified.append(0);
+	m_timesVisited.append(0);
+	m_visits.append(0);
+
+	return (m_types.count() - 1);
+}
+
+void BookmarksStore::removeBookmark(int bookmark)
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return;
+	}
+
+	releaseString(m_urls.at(bookmark));
+	releaseString(m_titles.at(bookmark));
+	releaseString(m_descriptions.at(bookmark));
+	releaseString(m_keywords.at(bookmark));
+
+	m_types[bookmark] = BookmarksItem::UnknownBookmark;
+	m_urls[bookmark] = -1;
+	m_titles[bookmark] = -1;
+	m_descriptions[bookmark] = -1;
+	m_keywords[bookmark] = -1;
+	m_timesAdded[bookmark] = 0;
+	m_timesModified[bookmark] = 0;
+	m_timesVisited[bookmark] = 0;
+	m_visits[bookmark] = 0;
+
+	m_freeBookmarks.append(bookmark);
+}
+
+int BookmarksStore::addString(const QString &value)
+{
+	if (value.isEmpty())
+	{
+		return -1;
+	}
+
+	int identifier = m_stringIdentifiers.value(value, -1);
+
+	if (identifier >= 0)
+	{
+		++m_stringReferences[identifier];
+
+		return identifier;
+	}
+
+	if (m_freeStrings.isEmpty())
+	{
+		identifier = m_strings.count();
+
+		m_strings.append(value);
+		m_stringReferences.append(1);
+	}
+	else
+	{
+		identifier = m_freeStrings.takeLast();
+
+		m_strings[identifier] = value;
+		m_stringReferences[identifier] = 1;
+	}
+
+	m_stringIdentifiers[value] = identifier;
+
+	return identifier;
+}
+
+void BookmarksStore::releaseString(int identifier)
+{
+	if (identifier < 0 || identifier >= m_strings.count())
+	{
+		return;
+	}
+
+	--m_stringReferences[identifier];
+
+	if (m_stringReferences.at(identifier) <= 0)
+	{
+		m_stringIdentifiers.remove(m_strings.at(identifier));
+
+		m_strings[identifier] = QString();
+		m_stringReferences[identifier] = 0;
+
+		m_freeStrings.append(identifier);
+	}
+}
+
+QString BookmarksStore::getString(int identifier) const
+{
+	if (identifier < 0 || identifier >= m_strings.count())
+	{
+		return QString();
+	}
+
+	return m_strings.at(identifier);
+}
+
+QVariant BookmarksStore::getStringData(int identifier) const
+{
+	if (identifier < 0)
+	{
+		return QVariant();
+	}
+
+	return m_strings.at(identifier);
+}
+
+QString BookmarksStore::getText(int bookmark, int role) const
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return QString();
+	}
+
+	switch (role)
+	{
+		case BookmarksModel::UrlRole:
+			return getString(m_urls.at(bookmark));
+		case BookmarksModel::TitleRole:
+			return getString(m_titles.at(bookmark));
+		case BookmarksModel::DescriptionRole:
+			return getString(m_descriptions.at(bookmark));
+		case BookmarksModel::KeywordRole:
+			return getString(m_keywords.at(bookmark));
+		default:
+			break;
+	}
+
+	return QString();
+}
+
+QDateTime BookmarksStore::createTime(qint64 time)
+{
+	if (time == 0)
+	{
+		return QDateTime();
+	}
+
+	return QDateTime::fromMSecsSinceEpoch(time, Qt::UTC);
+}
+
+QDateTime BookmarksStore::getTime(int bookmark, int role) const
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return QDateTime();
+	}
+
+	switch (role)
+	{
+		case BookmarksModel::TimeAddedRole:
+			return createTime(m_timesAdded.at(bookmark));
+		case BookmarksModel::TimeModifiedRole:
+			return createTime(m_timesModified.at(bookmark));
+		case BookmarksModel::TimeVisitedRole:
+			return createTime(m_timesVisited.at(bookmark));
+		default:
+			break;
+	}
+
+	return QDateTime();
+}
+
+QVariant BookmarksStore::getData(int bookmark, int role) const
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return QVariant();
+	}
+
+	switch (role)
+	{
+		case BookmarksModel::TypeRole:
+			return m_types.at(bookmark);
+		case BookmarksModel::UrlRole:
+			return getStringData(m_urls.at(bookmark));
+		case BookmarksModel::TitleRole:
+			return getStringData(m_titles.at(bookmark));
+		case BookmarksModel::DescriptionRole:
+			return getStringData(m_descriptions.at(bookmark));
+		case BookmarksModel::KeywordRole:
+			return getStringData(m_keywords.at(bookmark));
+		case BookmarksModel::TimeAddedRole:
+			return ((m_timesAdded.at(bookmark) != 0) ? QVariant(createTime(m_timesAdded.at(bookmark))) : QVariant());
+		case BookmarksModel::TimeModifiedRole:
+			return ((m_timesModified.at(bookmark) != 0) ? QVariant(createTime(m_timesModified.at(bookmark))) : QVariant());
+		case BookmarksModel::TimeVisitedRole:
+			return ((m_timesVisited.at(bookmark) != 0) ? QVariant(createTime(m_timesVisited.at(bookmark))) : QVariant());
+		case BookmarksModel::VisitsRole:
+			return ((m_visits.at(bookmark) > 0) ? QVariant(m_visits.at(bookmark)) : QVariant());
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+
+int BookmarksStore::getType(int bookmark) const
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return BookmarksItem::UnknownBookmark;
+	}
+
+	return m_types.at(bookmark);
+}
+
+int BookmarksStore::getVisits(int bookmark) const
+{
+	if (bookmark < 0 || bookmark >= m_visits.count())
+	{
+		return 0;
+	}
+
+	return m_visits.at(bookmark);
+}
+
+int BookmarksStore::getUrlIdentifier(int bookmark) const
+{
+	if (bookmark < 0 || bookmark >= m_urls.count())
+	{
+		return -1;
+	}
+
+	return m_urls.at(bookmark);
+}
+
+int BookmarksStore::findString(const QString &value) const
+{
+	return m_stringIdentifiers.value(value, -1);
+}
+
+int BookmarksStore::getBookmarksAmount() const
+{
+	return (m_types.count() - m_freeBookmarks.count());
+}
+
+int BookmarksStore::getStringsAmount() const
+{
+	return m_stringIdentifiers.count();
+}
+
+bool BookmarksStore::setString(QVector<int> &column, int bookmark, const QString &value)
+{
+	if (getString(column.at(bookmark)) == value)
+	{
+		return false;
+	}
+
+	const int identifier = addString(value);
+
+	releaseString(column.at(bookmark));
+
+	column[bookmark] = identifier;
+
+	return true;
+}
+
+bool BookmarksStore::setTime(QVector<qint64> &column, int bookmark, const QDateTime &value)
+{
+	const qint64 time = (value.isValid() ? value.toMSecsSinceEpoch() : 0);
+
+	if (column.at(bookmark) == time)
+	{
+		return false;
+	}
+
+	column[bookmark] = time;
+
+	return true;
+}
+
+bool BookmarksStore::setData(int bookmark, int role, const QVariant &value)
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return false;
+	}
+
+	switch (role)
+	{
+		case BookmarksModel::TypeRole:
+			if (m_types.at(bookmark) == value.toInt())
+			{
+				return false;
+			}
+
+			m_types[bookmark] = value.toInt();
+
+			return true;
+		case BookmarksModel::UrlRole:
+			return setString(m_urls, bookmark, value.toUrl().toString());
+		case BookmarksModel::TitleRole:
+			return setString(m_titles, bookmark, value.toString());
+		case BookmarksModel::DescriptionRole:
+			return setString(m_descriptions, bookmark, value.toString());
+		case BookmarksModel::KeywordRole:
+			return setString(m_keywords, bookmark, value.toString());
+		case BookmarksModel::TimeAddedRole:
+			return setTime(m_timesAdded, bookmark, value.toDateTime());
+		case BookmarksModel::TimeModifiedRole:
+			return setTime(m_timesModified, bookmark, value.toDateTime());
+		case BookmarksModel::TimeVisitedRole:
+			return setTime(m_timesVisited, bookmark, value.toDateTime());
+		case BookmarksModel::VisitsRole:
+			if (m_visits.at(bookmark) == value.toInt())
+			{
+				return false;
+			}
+
+			m_visits[bookmark] = value.toInt();
+
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+bool BookmarksStore::containsText(int bookmark, const QString &text) const
+{
+	if (bookmark < 0 || bookmark >= m_types.count())
+	{
+		return false;
+	}
+
+	return (getString(m_urls.at(bookmark)).contains(text, Qt::CaseInsensitive) || getString(m_titles.at(bookmark)).contains(text, Qt::CaseInsensitive) || getString(m_descriptions.at(bookmark)).contains(text, Qt::CaseInsensitive) || getString(m_keywords.at(bookmark)).contains(text, Qt::CaseInsensitive));
+}
+
+bool BookmarksStore::isStored(int role)
+{
+	switch (role)
+	{
+		case BookmarksModel::TypeRole:
+		case BookmarksModel::UrlRole:
+		case BookmarksModel::TitleRole:
+		case BookmarksModel::DescriptionRole:
+		case BookmarksModel::KeywordRole:
+		case BookmarksModel::TimeAddedRole:
+		case BookmarksModel::TimeModifiedRole:
+		case BookmarksModel::TimeVisitedRole:
+		case BookmarksModel::VisitsRole:
+			return true;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+}
@@ -0,0 +1,79 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_BOOKMARKSSTORE_H
+#define OTTER_BOOKMARKSSTORE_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class BookmarksStore
+{
+public:
+	BookmarksStore();
+
+	int createBookmark();
+	void removeBookmark(int bookmark);
+	QString getString(int identifier) const;
+	QString getText(int bookmark, int role) const;
+	QDateTime getTime(int bookmark, int role) const;
+	QVariant getData(int bookmark, int role) const;
+	int getType(int bookmark) const;
+	int getVisits(int bookmark) const;
+	int getUrlIdentifier(int bookmark) const;
+	int findString(const QString &value) const;
+	int getBookmarksAmount() const;
+	int getStringsAmount() const;
+	bool setData(int bookmark, int role, const QVariant &value);
+	bool containsText(int bookmark, const QString &text) const;
+	static bool isStored(int role);
+
+protected:
+	int addString(const QString &value);
+	void releaseString(int identifier);
+	bool setString(QVector<int> &column, int bookmark, const QString &value);
+	bool setTime(QVector<qint64> &column, int bookmark, const QDateTime &value);
+	QVariant getStringData(int identifier) const;
+	static QDateTime createTime(qint64 time);
+
+private:
+	QVector<quint8> m_types;
+	QVector<int> m_urls;
+	QVector<int> m_titles;
+	QVector<int> m_descriptions;
+	QVector<int> m_keywords;
+	QVector<qint64> m_timesAdded;
+	QVector<qint64> m_timesModified;
+	QVector<qint64> m_timesVisited;
+	QVector<int> m_visits;
+	QVector<int> m_freeBookmarks;
+	QVector<QString> m_strings;
+	QVector<int> m_stringReferences;
+	QVector<int> m_freeStrings;
+	QHash<QString, int> m_stringIdentifiers;
+};
+
+}
+
+#endif
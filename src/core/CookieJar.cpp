@@ -21,18 +21,23 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QDataStream>
-#include <QtCore/QFile>
-#include <QtCore/QSaveFile>
+#include <QtCore/QReadLocker>
 #include <QtCore/QTimerEvent>
+#include <QtCore/QVector>
+#include <QtCore/QWriteLocker>
+
+#include <algorithm>
 
 namespace Otter
 {
 
 CookieJar::CookieJar(bool isPrivate, QObject *parent) : QNetworkCookieJar(parent),
+	m_thread(NULL),
+	m_worker(NULL),
 	m_keepCookiesPolicy(UntilExpireKeepCookies),
 	m_thirdPartyCookiesAcceptPolicy(AlwaysAcceptCookies),
 	m_saveTimer(0),
+	m_expirationTimer(0),
 	m_enableCookies(true),
 	m_isPrivate(isPrivate)
 {
@@ -41,56 +46,96 @@ CookieJar::CookieJar(bool isPrivate, QObject *parent) : QNetworkCookieJar(parent
 		return;
 	}
 
-	QFile file(SessionsManager::getProfilePath() + QLatin1String("/cookies.dat"));
+	qRegisterMetaType<QList<CookieJarWorker::Change> >("QList<CookieJarWorker::Change>");
 
-	if (!file.open(QIODevice::ReadOnly))
-	{
-		return;
-	}
+	m_thread = new QThread(this);
+	m_worker = new CookieJarWorker(SessionsManager::getProfilePath() + QLatin1String("/cookies.dat"));
 
-	QList<QNetworkCookie> allCookies;
-	QDataStream stream(&file);
-	quint32 amount;
+	const QList<QNetworkCookie> cookies = m_worker->load();
 
-	stream >> amount;
+	m_worker->moveToThread(m_thread);
+	m_thread->start();
 
-	for (quint32 i = 0; i < amount; ++i)
-	{
-		QByteArray value;
+	optionChanged(QLatin1String("Browser/EnableCookies"), SettingsManager::getValue(QLatin1String("Browser/EnableCookies")));
+	m_store.setCookies(cookies);
 
-		stream >> value;
+	scheduleExpiration();
 
-		const QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(value);
+	connect(this, SIGNAL(requestedSave(QList<CookieJarWorker::Change>)), m_worker, SLOT(writeChanges(QList<CookieJarWorker::Change>)));
+	connect(this, SIGNAL(requestedClear()), m_worker, SLOT(clear()));
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
 
-		for (int j = 0; j < cookies.count(); ++j)
-		{
-			allCookies.append(cookies.at(j));
-		}
+CookieJar::CookieJar(const CookieJar *cookieJar, QObject *parent) : QNetworkCookieJar(parent),
+	m_thread(NULL),
+	m_worker(NULL),
+	m_store(cookieJar->getSnapshot()),
+	m_keepCookiesPolicy(cookieJar->m_keepCookiesPolicy),
+	m_thirdPartyCookiesAcceptPolicy(cookieJar->m_thirdPartyCookiesAcceptPolicy),
+	m_saveTimer(0),
+	m_expirationTimer(0),
+	m_enableCookies(cookieJar->m_enableCookies),
+	m_isPrivate(true)
+{
+	scheduleExpiration();
+}
 
-		if (stream.atEnd())
-		{
-			break;
-		}
+CookieJar::~CookieJar()
+{
+	if (!m_thread)
+	{
+		save();
+
+		return;
 	}
 
-	optionChanged(QLatin1String("Browser/EnableCookies"), SettingsManager::getValue(QLatin1String("Browser/EnableCookies")));
-	setAllCookies(allCookies);
+	QMetaObject::invokeMethod(m_worker, "writeChanges", Qt::BlockingQueuedConnection, Q_ARG(QList<CookieJarWorker::Change>, m_pendingChanges));
 
-	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+	m_thread->quit();
+	m_thread->wait();
+
+	delete m_worker;
 }
 
 void CookieJar::timerEvent(QTimerEvent *event)
 {
-	if (event->timerId() != m_saveTimer)
+	if (event->timerId() == m_saveTimer)
 	{
-		return;
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		save();
 	}
+	else if (event->timerId() == m_expirationTimer)
+	{
+		killTimer(m_expirationTimer);
+
+		m_expirationTimer = 0;
 
-	killTimer(m_saveTimer);
+		QWriteLocker locker(&m_lock);
+		const QList<QNetworkCookie> cookies = m_store.takeExpiredCookies(QDateTime::currentDateTimeUtc());
 
-	m_saveTimer = 0;
+		locker.unlock();
+
+		m_accessMutex.lock();
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			m_accessTimes.remove(CookiesStore::getIdentifier(cookies.at(i)));
+		}
+
+		m_accessMutex.unlock();
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			scheduleSave(cookies.at(i), true);
+
+			emit cookieRemoved(cookies.at(i));
+		}
 
-	save();
+		scheduleExpiration();
+	}
 }
 
 void CookieJar::optionChanged(const QString &option, const QVariant &value)
@@ -109,48 +154,130 @@ void CookieJar::clearCookies(int period)
 {
 	Q_UNUSED(period)
 
-	setAllCookies(QList<QNetworkCookie>());
-	save();
+	m_lock.lockForWrite();
+	m_store.clear();
+	m_lock.unlock();
+
+	m_accessMutex.lock();
+	m_accessTimes.clear();
+	m_accessMutex.unlock();
+
+	if (m_expirationTimer != 0)
+	{
+		killTimer(m_expirationTimer);
+
+		m_expirationTimer = 0;
+	}
+
+	if (m_saveTimer != 0)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+	}
+
+	m_pendingChanges.clear();
+
+	if (!m_isPrivate)
+	{
+		emit requestedClear();
+	}
 }
 
-void CookieJar::scheduleSave()
+void CookieJar::scheduleSave(const QNetworkCookie &cookie, bool isRemoval)
 {
-	if (!m_isPrivate && m_saveTimer == 0)
+	if (m_isPrivate)
+	{
+		return;
+	}
+
+	m_pendingChanges.append(CookieJarWorker::createChange(cookie, isRemoval));
+
+	if (m_saveTimer == 0)
 	{
 		m_saveTimer = startTimer(500);
 	}
 }
 
-void CookieJar::save()
+void CookieJar::scheduleExpiration()
 {
-	QSaveFile file(SessionsManager::getProfilePath() + QLatin1String("/cookies.dat"));
+	if (m_expirationTimer != 0)
+	{
+		killTimer(m_expirationTimer);
+
+		m_expirationTimer = 0;
+	}
 
-	if (!file.open(QIODevice::WriteOnly))
+	m_lock.lockForRead();
+
+	const QDateTime expiration = m_store.getNextExpiration();
+
+	m_lock.unlock();
+
+	if (expiration.isValid())
 	{
-		return;
+		m_expirationTimer = startTimer((int) qBound(qint64(0), (QDateTime::currentDateTimeUtc().msecsTo(expiration) + 1), qint64(3600000)));
 	}
+}
+
+void CookieJar::evictCookies(const QNetworkCookie &cookie)
+{
+	const QString domain = CookiesStore::getRegistrableDomain(cookie.domain());
+
+	m_lock.lockForRead();
+
+	const int domainAmount = m_store.getRegistrableDomainCookiesAmount(domain);
 
-	QList<QNetworkCookie> cookies = allCookies();
-	QDataStream stream(&file);
-	stream << quint32(cookies.size());
+	m_lock.unlock();
 
-	for (int i = 0; i < cookies.size(); ++i)
+	if (domainAmount > MaximumDomainCookiesAmount)
 	{
-		if (!cookies.at(i).isSessionCookie())
+		m_lock.lockForRead();
+
+		const QList<QNetworkCookie> domainCookies = m_store.getRegistrableDomainCookies(domain);
+
+		m_lock.unlock();
+
+		const QList<QNetworkCookie> cookies = getLeastRecentlyUsedCookies(domainCookies, (domainCookies.count() - PrunedDomainCookiesAmount));
+
+		for (int i = 0; i < cookies.count(); ++i)
 		{
-			stream << cookies.at(i).toRawForm();
+			deleteCookie(cookies.at(i));
 		}
 	}
 
-	file.commit();
+	m_lock.lockForRead();
+
+	const int amount = m_store.getCookiesAmount();
+
+	m_lock.unlock();
+
+	if (amount > MaximumCookiesAmount)
+	{
+		const QList<QNetworkCookie> cookies = getLeastRecentlyUsedCookies(getCookies(), (amount - PrunedCookiesAmount));
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			deleteCookie(cookies.at(i));
+		}
+	}
 }
 
-CookieJar* CookieJar::clone(QObject *parent)
+void CookieJar::save()
 {
-	CookieJar *cookieJar = new CookieJar(m_isPrivate, parent);
-	cookieJar->setAllCookies(allCookies());
+	if (m_pendingChanges.isEmpty())
+	{
+		return;
+	}
+
+	emit requestedSave(m_pendingChanges);
 
-	return cookieJar;
+	m_pendingChanges.clear();
+}
+
+CookieJar* CookieJar::clone(QObject *parent)
+{
+	return new CookieJar(this, parent);
 }
 
 QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
@@ -160,28 +287,71 @@ QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 		return QList<QNetworkCookie>();
 	}
 
-	return QNetworkCookieJar::cookiesForUrl(url);
+	m_lock.lockForRead();
+
+	const QList<QNetworkCookie> cookies = m_store.getCookiesForUrl(url);
+	const bool isTracking = (!cookies.isEmpty() && (m_store.getCookiesAmount() > AccessTrackingThreshold || m_store.getRegistrableDomainCookiesAmount(CookiesStore::getRegistrableDomain(url.host())) > AccessTrackingDomainThreshold));
+
+	m_lock.unlock();
+
+	if (isTracking && m_accessMutex.tryLock())
+	{
+		const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			m_accessTimes[CookiesStore::getIdentifier(cookies.at(i))] = now;
+		}
+
+		m_accessMutex.unlock();
+	}
+
+	return cookies;
 }
 
 QList<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 {
-	if (!domain.isEmpty())
+	QReadLocker locker(&m_lock);
+
+	return m_store.getCookies(domain);
+}
+
+QList<QNetworkCookie> CookieJar::getLeastRecentlyUsedCookies(const QList<QNetworkCookie> &cookies, int amount) const
+{
+	if (amount <= 0)
 	{
-		const QList<QNetworkCookie> cookies = allCookies();
-		QList<QNetworkCookie> domainCookies;
+		return QList<QNetworkCookie>();
+	}
 
-		for (int i = 0; i < cookies.length(); ++i)
-		{
-			if (cookies.at(i).domain() == domain || (cookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(cookies.at(i).domain())))
-			{
-				domainCookies.append(cookies.at(i));
-			}
-		}
+	QVector<QPair<qint64, int> > accessTimes;
+	accessTimes.reserve(cookies.count());
 
-		return domainCookies;
+	m_accessMutex.lock();
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		accessTimes.append(qMakePair(m_accessTimes.value(CookiesStore::getIdentifier(cookies.at(i)), 0), i));
 	}
 
-	return allCookies();
+	m_accessMutex.unlock();
+
+	std::sort(accessTimes.begin(), accessTimes.end());
+
+	QList<QNetworkCookie> leastRecentlyUsedCookies;
+
+	for (int i = 0; i < qMin(amount, accessTimes.count()); ++i)
+	{
+		leastRecentlyUsedCookies.append(cookies.at(accessTimes.at(i).second));
+	}
+
+	return leastRecentlyUsedCookies;
+}
+
+CookiesStore CookieJar::getSnapshot() const
+{
+	QReadLocker locker(&m_lock);
+
+	return m_store;
 }
 
 CookieJar::KeepCookiesPolicy CookieJar::getKeepCookiesPolicy() const
@@ -201,30 +371,62 @@ bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 		return false;
 	}
 
-	const bool result = QNetworkCookieJar::insertCookie(cookie);
+	if (!cookie.isSessionCookie() && cookie.expirationDate() < QDateTime::currentDateTimeUtc())
+	{
+		deleteCookie(cookie);
+
+		return false;
+	}
+
+	m_lock.lockForWrite();
+
+	const bool isReplaced = m_store.insertCookie(cookie);
 
-	if (result)
+	m_lock.unlock();
+
+	m_accessMutex.lock();
+	m_accessTimes[CookiesStore::getIdentifier(cookie)] = QDateTime::currentMSecsSinceEpoch();
+	m_accessMutex.unlock();
+
+	if (!cookie.isSessionCookie())
 	{
-		scheduleSave();
+		scheduleExpiration();
+	}
+
+	scheduleSave(cookie, false);
+
+	emit cookieAdded(cookie);
 
-		emit cookieAdded(cookie);
+	if (!isReplaced)
+	{
+		evictCookies(cookie);
 	}
 
-	return result;
+	return true;
 }
 
 bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
-	const bool result = QNetworkCookieJar::deleteCookie(cookie);
+	m_lock.lockForWrite();
 
-	if (result)
-	{
-		scheduleSave();
+	const bool isRemoved = m_store.removeCookie(cookie);
 
-		emit cookieRemoved(cookie);
+	m_lock.unlock();
+
+	if (!isRemoved)
+	{
+		return false;
 	}
 
-	return result;
+	m_accessMutex.lock();
+	m_accessTimes.remove(CookiesStore::getIdentifier(cookie));
+	m_accessMutex.unlock();
+
+	scheduleSave(cookie, true);
+
+	emit cookieRemoved(cookie);
+
+	return true;
 }
 
 bool CookieJar::updateCookie(const QNetworkCookie &cookie)
@@ -234,14 +436,7 @@ bool CookieJar::updateCookie(const QNetworkCookie &cookie)
 		return false;
 	}
 
-	const bool result = QNetworkCookieJar::updateCookie(cookie);
-
-	if (result)
-	{
-		scheduleSave();
-	}
-
-	return result;
+	return QNetworkCookieJar::updateCookie(cookie);
 }
 
 }
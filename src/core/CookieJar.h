@@ -20,6 +20,12 @@
 #ifndef OTTER_COOKIEJAR_H
 #define OTTER_COOKIEJAR_H
 
+#include "CookieJarWorker.h"
+#include "CookiesStore.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QThread>
 #include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkCookieJar>
 
@@ -47,11 +53,13 @@ public:
 	};
 
 	explicit CookieJar(bool isPrivate, QObject *parent = NULL);
+	~CookieJar();
 
 	void clearCookies(int period = 0);
 	CookieJar* clone(QObject *parent = NULL);
 	QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const;
 	QList<QNetworkCookie> getCookies(const QString &domain = QString()) const;
+	CookiesStore getSnapshot() const;
 	KeepCookiesPolicy getKeepCookiesPolicy() const;
 	ThirdPartyCookiesAcceptPolicy getThirdPartyCookiesAcceptPolicy() const;
 	bool insertCookie(const QNetworkCookie &cookie);
@@ -59,21 +67,46 @@ public:
 	bool updateCookie(const QNetworkCookie &cookie);
 
 protected:
+	enum CookiesAmountLimit
+	{
+		AccessTrackingDomainThreshold = 150,
+		AccessTrackingThreshold = 3000,
+		PrunedDomainCookiesAmount = 150,
+		PrunedCookiesAmount = 3000,
+		MaximumDomainCookiesAmount = 180,
+		MaximumCookiesAmount = 3300
+	};
+
+	CookieJar(const CookieJar *cookieJar, QObject *parent);
+
 	void timerEvent(QTimerEvent *event);
-	void scheduleSave();
+	void scheduleSave(const QNetworkCookie &cookie, bool isRemoval);
+	void scheduleExpiration();
+	void evictCookies(const QNetworkCookie &cookie);
 	void save();
+	QList<QNetworkCookie> getLeastRecentlyUsedCookies(const QList<QNetworkCookie> &cookies, int amount) const;
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 
 private:
+	QThread *m_thread;
+	CookieJarWorker *m_worker;
+	QList<CookieJarWorker::Change> m_pendingChanges;
+	CookiesStore m_store;
+	mutable QHash<QByteArray, qint64> m_accessTimes;
+	mutable QReadWriteLock m_lock;
+	mutable QMutex m_accessMutex;
 	KeepCookiesPolicy m_keepCookiesPolicy;
 	ThirdPartyCookiesAcceptPolicy m_thirdPartyCookiesAcceptPolicy;
 	int m_saveTimer;
+	int m_expirationTimer;
 	bool m_enableCookies;
 	bool m_isPrivate;
 
 signals:
+	void requestedSave(const QList<CookieJarWorker::Change> &changes);
+	void requestedClear();
 	void cookieAdded(QNetworkCookie cookie);
 	void cookieRemoved(QNetworkCookie cookie);
 };
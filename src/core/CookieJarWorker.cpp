@@ -0,0 +1,331 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CookieJarWorker.h"
+#include "Console.h"
+#include "CookiesStore.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+CookieJarWorker::CookieJarWorker(const QString &path, QObject *parent) : QObject(parent),
+	m_path(path),
+	m_journal(NULL)
+{
+}
+
+void CookieJarWorker::writeChanges(const QList<CookieJarWorker::Change> &changes)
+{
+	if (changes.isEmpty())
+	{
+		return;
+	}
+
+	if (!m_journal)
+	{
+		m_journal = new QFile(getJournalPath(), this);
+
+		if (!m_journal->open(QIODevice::Append))
+		{
+			Console::addMessage(tr("Failed to open cookies journal: %0").arg(m_journal->errorString()), OtherMessageCategory, ErrorMessageLevel);
+
+			delete m_journal;
+
+			m_journal = NULL;
+		}
+		else if (m_journal->size() == 0)
+		{
+			QDataStream stream(m_journal);
+			stream << quint32(0x4f434a4c) << quint32(1);
+		}
+	}
+
+	QByteArray records;
+	QDataStream stream(&records, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_2);
+
+	for (int i = 0; i < changes.count(); ++i)
+	{
+		applyChange(changes.at(i));
+
+		if (changes.at(i).isRemoval)
+		{
+			stream << quint8(RemoveOperation) << changes.at(i).key;
+		}
+		else
+		{
+			stream << quint8(InsertOperation) << changes.at(i).key << changes.at(i).cookie.toRawForm();
+		}
+	}
+
+	if (!m_journal)
+	{
+		compact();
+
+		return;
+	}
+
+	m_journal->write(records);
+	m_journal->flush();
+
+	if (m_journal->size() > 262144)
+	{
+		compact();
+	}
+}
+
+void CookieJarWorker::clear()
+{
+	m_cookies.clear();
+
+	compact();
+}
+
+void CookieJarWorker::compact()
+{
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(tr("Failed to save cookies: %0").arg(file.errorString()), OtherMessageCategory, ErrorMessageLevel);
+
+		return;
+	}
+
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+	QList<QByteArray> values;
+	values.reserve(m_cookies.count());
+
+	QHash<QByteArray, QNetworkCookie>::iterator iterator = m_cookies.begin();
+
+	while (iterator != m_cookies.end())
+	{
+		if (iterator.value().expirationDate() < now)
+		{
+			iterator = m_cookies.erase(iterator);
+		}
+		else
+		{
+			values.append(iterator.value().toRawForm());
+
+			++iterator;
+		}
+	}
+
+	QDataStream stream(&file);
+	stream << quint32(0x4f434b53) << quint32(2);
+
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << quint32(values.count());
+
+	for (int i = 0; i < values.count(); ++i)
+	{
+		stream << values.at(i);
+	}
+
+	if (!file.commit())
+	{
+		Console::addMessage(tr("Failed to save cookies: %0").arg(file.errorString()), OtherMessageCategory, ErrorMessageLevel);
+
+		return;
+	}
+
+	if (m_journal)
+	{
+		m_journal->close();
+
+		delete m_journal;
+
+		m_journal = NULL;
+	}
+
+	QFile::remove(getJournalPath());
+}
+
+void CookieJarWorker::applyChange(const Change &change)
+{
+	if (change.isRemoval)
+	{
+		m_cookies.remove(change.key);
+	}
+	else
+	{
+		m_cookies[change.key] = change.cookie;
+	}
+}
+
+void CookieJarWorker::replayJournal()
+{
+	QFile file(getJournalPath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	quint32 magic;
+	quint32 version;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4f434a4c || version != 1)
+	{
+		Console::addMessage(tr("Failed to replay cookies journal: unsupported format"), OtherMessageCategory, ErrorMessageLevel);
+
+		return;
+	}
+
+	stream.setVersion(QDataStream::Qt_5_2);
+
+	while (!stream.atEnd())
+	{
+		quint8 operation;
+		Change change;
+
+		stream >> operation >> change.key;
+
+		if (operation == InsertOperation)
+		{
+			QByteArray value;
+
+			stream >> value;
+
+			change.cookie = parseCookie(value);
+		}
+		else if (operation == RemoveOperation)
+		{
+			change.isRemoval = true;
+		}
+		else
+		{
+			break;
+		}
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		if (change.isRemoval || !change.cookie.name().isEmpty())
+		{
+			applyChange(change);
+		}
+	}
+}
+
+bool CookieJarWorker::readSnapshot()
+{
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	quint32 header;
+	quint32 amount;
+
+	stream >> header;
+
+	if (header == 0x4f434b53)
+	{
+		quint32 version;
+
+		stream >> version;
+
+		if (version != 2)
+		{
+			Console::addMessage(tr("Failed to load cookies: unsupported format"), OtherMessageCategory, ErrorMessageLevel);
+
+			return false;
+		}
+
+		stream.setVersion(QDataStream::Qt_5_2);
+		stream >> amount;
+	}
+	else
+	{
+		amount = header;
+	}
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		QByteArray value;
+
+		stream >> value;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		const QNetworkCookie cookie = parseCookie(value);
+
+		if (!cookie.name().isEmpty())
+		{
+			applyChange(createChange(cookie, false));
+		}
+	}
+
+	return true;
+}
+
+QString CookieJarWorker::getJournalPath() const
+{
+	return m_path + QLatin1String(".journal");
+}
+
+QList<QNetworkCookie> CookieJarWorker::load()
+{
+	m_cookies.clear();
+
+	readSnapshot();
+	replayJournal();
+
+	return m_cookies.values();
+}
+
+QNetworkCookie CookieJarWorker::parseCookie(const QByteArray &value)
+{
+	const QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(value);
+
+	return (cookies.isEmpty() ? QNetworkCookie() : cookies.first());
+}
+
+CookieJarWorker::Change CookieJarWorker::createChange(const QNetworkCookie &cookie, bool isRemoval)
+{
+	Change change;
+	change.key = CookiesStore::getIdentifier(cookie);
+	change.isRemoval = (isRemoval || cookie.isSessionCookie());
+
+	if (!change.isRemoval)
+	{
+		change.cookie = cookie;
+	}
+
+	return change;
+}
+
+}
@@ -0,0 +1,77 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COOKIEJARWORKER_H
+#define OTTER_COOKIEJARWORKER_H
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtNetwork/QNetworkCookie>
+
+namespace Otter
+{
+
+class CookieJarWorker : public QObject
+{
+	Q_OBJECT
+
+public:
+	struct Change
+	{
+		QByteArray key;
+		QNetworkCookie cookie;
+		bool isRemoval;
+
+		Change() : isRemoval(false) {}
+	};
+
+	explicit CookieJarWorker(const QString &path, QObject *parent = NULL);
+
+	QList<QNetworkCookie> load();
+	static Change createChange(const QNetworkCookie &cookie, bool isRemoval);
+
+public slots:
+	void writeChanges(const QList<CookieJarWorker::Change> &changes);
+	void clear();
+
+protected:
+	enum JournalOperation
+	{
+		UnknownOperation = 0,
+		InsertOperation = 1,
+		RemoveOperation = 2
+	};
+
+	void compact();
+	void applyChange(const Change &change);
+	void replayJournal();
+	bool readSnapshot();
+	static QNetworkCookie parseCookie(const QByteArray &value);
+	QString getJournalPath() const;
+
+private:
+	QString m_path;
+	QFile *m_journal;
+	QHash<QByteArray, QNetworkCookie> m_cookies;
+};
+
+}
+
+#endif
@@ -0,0 +1,354 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CookiesStore.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QUrl>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+QHash<QString, QString> CookiesStore::m_registrableDomains;
+QMutex CookiesStore::m_registrableDomainsMutex;
+
+CookiesStore::CookiesStore() : m_data(new StoreData())
+{
+}
+
+bool CookiesStore::insertCookie(const QNetworkCookie &cookie)
+{
+	const QString key = getDomainKey(cookie.domain());
+	const QString registrableDomain = getRegistrableDomain(key);
+	QList<QNetworkCookie> &cookies = m_data->domains[registrableDomain][key];
+	bool isReplaced = false;
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (cookies.at(i).hasSameIdentifier(cookie))
+		{
+			removeExpiration(cookies.at(i));
+
+			cookies[i] = cookie;
+
+			isReplaced = true;
+
+			break;
+		}
+	}
+
+	if (!isReplaced)
+	{
+		cookies.append(cookie);
+
+		++m_data->domainAmounts[registrableDomain];
+		++m_data->amount;
+	}
+
+	if (!cookie.isSessionCookie())
+	{
+		m_data->expirations.insert(cookie.expirationDate().toMSecsSinceEpoch(), cookie);
+	}
+
+	return isReplaced;
+}
+
+void CookiesStore::setCookies(const QList<QNetworkCookie> &cookies)
+{
+	clear();
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		insertCookie(cookies.at(i));
+	}
+}
+
+void CookiesStore::removeExpiration(const QNetworkCookie &cookie)
+{
+	if (cookie.isSessionCookie())
+	{
+		return;
+	}
+
+	const qint64 expiration = cookie.expirationDate().toMSecsSinceEpoch();
+	QMultiMap<qint64, QNetworkCookie>::iterator iterator = m_data->expirations.find(expiration);
+
+	while (iterator != m_data->expirations.end() && iterator.key() == expiration)
+	{
+		if (iterator.value().hasSameIdentifier(cookie))
+		{
+			m_data->expirations.erase(iterator);
+
+			return;
+		}
+
+		++iterator;
+	}
+}
+
+void CookiesStore::clear()
+{
+	m_data = new StoreData();
+}
+
+QList<QNetworkCookie> CookiesStore::takeExpiredCookies(const QDateTime &now)
+{
+	const qint64 time = now.toMSecsSinceEpoch();
+	QList<QNetworkCookie> cookies;
+
+	while (!m_data.constData()->expirations.isEmpty() && m_data.constData()->expirations.constBegin().key() < time)
+	{
+		const QNetworkCookie cookie = m_data.constData()->expirations.constBegin().value();
+
+		removeCookie(cookie);
+
+		cookies.append(cookie);
+	}
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookiesStore::getCandidateCookies(const QString &host) const
+{
+	const QString registrableDomain = getRegistrableDomain(host);
+	QHash<QString, QHash<QString, QList<QNetworkCookie> > >::const_iterator domainIterator = m_data->domains.constFind(registrableDomain);
+
+	if (domainIterator == m_data->domains.constEnd())
+	{
+		return QList<QNetworkCookie>();
+	}
+
+	const QHash<QString, QList<QNetworkCookie> > &hosts = domainIterator.value();
+	QList<QNetworkCookie> cookies = hosts.value(host);
+	QString domain = host;
+
+	while (!domain.isEmpty())
+	{
+		cookies.append(hosts.value(QLatin1Char('.') + domain));
+
+		const int separator = domain.indexOf(QLatin1Char('.'));
+
+		if (domain == registrableDomain || separator < 0)
+		{
+			break;
+		}
+
+		domain = domain.mid(separator + 1);
+	}
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookiesStore::getCookiesForUrl(const QUrl &url) const
+{
+	const QList<QNetworkCookie> candidates = getCandidateCookies(getDomainKey(url.host()));
+
+	if (candidates.isEmpty())
+	{
+		return candidates;
+	}
+
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+	const QString path = url.path();
+	const bool isEncrypted = (url.scheme() == QLatin1String("https"));
+	const bool hasExpiredCookies = (!m_data->expirations.isEmpty() && m_data->expirations.constBegin().key() < now.toMSecsSinceEpoch());
+	QList<QNetworkCookie> cookies;
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		const QNetworkCookie &cookie = candidates.at(i);
+
+		if (!isParentPath(path, cookie.path()) || (cookie.isSecure() && !isEncrypted) || (hasExpiredCookies && !cookie.isSessionCookie() && cookie.expirationDate() < now))
+		{
+			continue;
+		}
+
+		cookies.append(cookie);
+	}
+
+	std::stable_sort(cookies.begin(), cookies.end(), comparePathLength);
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookiesStore::getCookies(const QString &domain) const
+{
+	if (!domain.isEmpty())
+	{
+		return getCandidateCookies(getDomainKey(domain));
+	}
+
+	QList<QNetworkCookie> cookies;
+	cookies.reserve(m_data->amount);
+
+	QHash<QString, QHash<QString, QList<QNetworkCookie> > >::const_iterator domainIterator;
+
+	for (domainIterator = m_data->domains.constBegin(); domainIterator != m_data->domains.constEnd(); ++domainIterator)
+	{
+		QHash<QString, QList<QNetworkCookie> >::const_iterator hostIterator;
+
+		for (hostIterator = domainIterator.value().constBegin(); hostIterator != domainIterator.value().constEnd(); ++hostIterator)
+		{
+			cookies.append(hostIterator.value());
+		}
+	}
+
+	return cookies;
+}
+
+QList<QNetworkCookie> CookiesStore::getRegistrableDomainCookies(const QString &domain) const
+{
+	QList<QNetworkCookie> cookies;
+	const QHash<QString, QList<QNetworkCookie> > hosts = m_data->domains.value(domain);
+	QHash<QString, QList<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = hosts.constBegin(); iterator != hosts.constEnd(); ++iterator)
+	{
+		cookies.append(iterator.value());
+	}
+
+	return cookies;
+}
+
+QString CookiesStore::getRegistrableDomain(const QString &domain)
+{
+	const QString host = (domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain);
+	QMutexLocker locker(&m_registrableDomainsMutex);
+	QHash<QString, QString>::const_iterator iterator = m_registrableDomains.constFind(host);
+
+	if (iterator != m_registrableDomains.constEnd())
+	{
+		return iterator.value();
+	}
+
+	if (m_registrableDomains.count() > 10000)
+	{
+		m_registrableDomains.clear();
+	}
+
+	const QString suffix = QUrl(QLatin1String("http://") + host).topLevelDomain();
+	QString registrableDomain = host;
+
+	if (!suffix.isEmpty() && host.length() > suffix.length())
+	{
+		const QString prefix = host.left(host.length() - suffix.length());
+
+		registrableDomain = prefix.mid(prefix.lastIndexOf(QLatin1Char('.')) + 1) + suffix;
+	}
+
+	m_registrableDomains[host] = registrableDomain;
+
+	return registrableDomain;
+}
+
+QString CookiesStore::getDomainKey(const QString &domain)
+{
+	return domain.toLower();
+}
+
+QByteArray CookiesStore::getIdentifier(const QNetworkCookie &cookie)
+{
+	return (getDomainKey(cookie.domain()).toUtf8() + '\t' + cookie.path().toUtf8() + '\t' + cookie.name());
+}
+
+QDateTime CookiesStore::getNextExpiration() const
+{
+	if (m_data->expirations.isEmpty())
+	{
+		return QDateTime();
+	}
+
+	return QDateTime::fromMSecsSinceEpoch(m_data->expirations.constBegin().key()).toUTC();
+}
+
+int CookiesStore::getCookiesAmount() const
+{
+	return m_data->amount;
+}
+
+int CookiesStore::getRegistrableDomainCookiesAmount(const QString &domain) const
+{
+	return m_data->domainAmounts.value(domain, 0);
+}
+
+bool CookiesStore::isParentPath(const QString &path, const QString &reference)
+{
+	if ((path.isEmpty() && reference == QLatin1String("/")) || path.startsWith(reference))
+	{
+		return (path.length() == reference.length() || reference.endsWith(QLatin1Char('/')) || (path.length() > reference.length() && path.at(reference.length()) == QLatin1Char('/')));
+	}
+
+	return false;
+}
+
+bool CookiesStore::comparePathLength(const QNetworkCookie &first, const QNetworkCookie &second)
+{
+	return (first.path().length() > second.path().length());
+}
+
+bool CookiesStore::removeCookie(const QNetworkCookie &cookie)
+{
+	const QString key = getDomainKey(cookie.domain());
+	const QString registrableDomain = getRegistrableDomain(key);
+
+	if (!m_data.constData()->domains.value(registrableDomain).contains(key))
+	{
+		return false;
+	}
+
+	QHash<QString, QHash<QString, QList<QNetworkCookie> > >::iterator domainIterator = m_data->domains.find(registrableDomain);
+	QHash<QString, QList<QNetworkCookie> >::iterator hostIterator = domainIterator.value().find(key);
+
+	QList<QNetworkCookie> &cookies = hostIterator.value();
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		if (!cookies.at(i).hasSameIdentifier(cookie))
+		{
+			continue;
+		}
+
+		removeExpiration(cookies.takeAt(i));
+
+		if (cookies.isEmpty())
+		{
+			domainIterator.value().erase(hostIterator);
+
+			if (domainIterator.value().isEmpty())
+			{
+				m_data->domains.erase(domainIterator);
+			}
+		}
+
+		--m_data->amount;
+
+		if (--m_data->domainAmounts[registrableDomain] <= 0)
+		{
+			m_data->domainAmounts.remove(registrableDomain);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+}
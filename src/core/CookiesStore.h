@@ -0,0 +1,79 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COOKIESSTORE_H
+#define OTTER_COOKIESSTORE_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMultiMap>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedData>
+#include <QtCore/QStringList>
+#include <QtNetwork/QNetworkCookie>
+
+namespace Otter
+{
+
+class CookiesStore
+{
+public:
+	CookiesStore();
+
+	bool insertCookie(const QNetworkCookie &cookie);
+	void setCookies(const QList<QNetworkCookie> &cookies);
+	void clear();
+	QList<QNetworkCookie> takeExpiredCookies(const QDateTime &now);
+	QList<QNetworkCookie> getCookiesForUrl(const QUrl &url) const;
+	QList<QNetworkCookie> getCookies(const QString &domain = QString()) const;
+	QList<QNetworkCookie> getRegistrableDomainCookies(const QString &domain) const;
+	static QString getRegistrableDomain(const QString &domain);
+	static QByteArray getIdentifier(const QNetworkCookie &cookie);
+	QDateTime getNextExpiration() const;
+	int getCookiesAmount() const;
+	int getRegistrableDomainCookiesAmount(const QString &domain) const;
+	bool removeCookie(const QNetworkCookie &cookie);
+
+protected:
+	struct StoreData : public QSharedData
+	{
+		QHash<QString, QHash<QString, QList<QNetworkCookie> > > domains;
+		QMultiMap<qint64, QNetworkCookie> expirations;
+		QHash<QString, int> domainAmounts;
+		int amount;
+
+		StoreData() : amount(0) {}
+	};
+
+	void removeExpiration(const QNetworkCookie &cookie);
+	QList<QNetworkCookie> getCandidateCookies(const QString &host) const;
+	static QString getDomainKey(const QString &domain);
+	static bool isParentPath(const QString &path, const QString &reference);
+	static bool comparePathLength(const QNetworkCookie &first, const QNetworkCookie &second);
+
+private:
+	QSharedDataPointer<StoreData> m_data;
+
+	static QHash<QString, QString> m_registrableDomains;
+	static QMutex m_registrableDomainsMutex;
+};
+
+}
+
+#endif
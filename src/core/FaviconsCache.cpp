@@ -0,0 +1,140 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FaviconsCache.h"
+#include "AddonsManager.h"
+#include "Utils.h"
+#include "WebBackend.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+FaviconsCache* FaviconsCache::m_instance = NULL;
+
+FaviconsCache::FaviconsCache(QObject *parent) : QObject(parent),
+	m_icons(512),
+	m_resolveTimer(0)
+{
+}
+
+void FaviconsCache::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_resolveTimer)
+	{
+		return;
+	}
+
+	WebBackend *backend = AddonsManager::getWebBackend();
+
+	if (!backend)
+	{
+		return;
+	}
+
+	QStringList keys;
+	QHash<QString, QUrl>::iterator iterator = m_pendingUrls.begin();
+
+	while (iterator != m_pendingUrls.end() && keys.count() < 20)
+	{
+		m_icons.insert(iterator.key(), new QIcon(backend->getIconForUrl(iterator.value())));
+
+		keys.append(iterator.key());
+
+		iterator = m_pendingUrls.erase(iterator);
+	}
+
+	if (m_pendingUrls.isEmpty())
+	{
+		killTimer(m_resolveTimer);
+
+		m_resolveTimer = 0;
+	}
+
+	if (!keys.isEmpty())
+	{
+		emit iconsChanged(keys);
+	}
+}
+
+void FaviconsCache::createInstance(QObject *parent)
+{
+	if (!m_instance)
+	{
+		m_instance = new FaviconsCache(parent);
+	}
+}
+
+void FaviconsCache::invalidate(const QUrl &url)
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	const QString key = getKey(url);
+
+	if (m_instance->m_icons.remove(key))
+	{
+		emit m_instance->iconsChanged(QStringList(key));
+	}
+}
+
+FaviconsCache* FaviconsCache::getInstance()
+{
+	return m_instance;
+}
+
+QIcon FaviconsCache::getIcon(const QUrl &url)
+{
+	if (!m_instance)
+	{
+		WebBackend *backend = AddonsManager::getWebBackend();
+
+		return (backend ? backend->getIconForUrl(url) : Utils::getIcon(QLatin1String("text-html")));
+	}
+
+	const QString key = getKey(url);
+	QIcon *icon = m_instance->m_icons.object(key);
+
+	if (icon)
+	{
+		return *icon;
+	}
+
+	if (!m_instance->m_pendingUrls.contains(key))
+	{
+		m_instance->m_pendingUrls.insert(key, url);
+
+		if (m_instance->m_resolveTimer == 0)
+		{
+			m_instance->m_resolveTimer = m_instance->startTimer(0);
+		}
+	}
+
+	return Utils::getIcon(QLatin1String("text-html"));
+}
+
+QString FaviconsCache::getKey(const QUrl &url)
+{
+	return (url.host().isEmpty() ? url.toString(QUrl::RemoveQuery | QUrl::RemoveFragment) : url.host().toLower());
+}
+
+}
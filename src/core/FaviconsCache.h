@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FAVICONSCACHE_H
+#define OTTER_FAVICONSCACHE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+#include <QtGui/QIcon>
+
+namespace Otter
+{
+
+class FaviconsCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void invalidate(const QUrl &url);
+	static FaviconsCache* getInstance();
+	static QIcon getIcon(const QUrl &url);
+	static QString getKey(const QUrl &url);
+
+protected:
+	explicit FaviconsCache(QObject *parent = NULL);
+
+	void timerEvent(QTimerEvent *event);
+
+private:
+	QCache<QString, QIcon> m_icons;
+	QHash<QString, QUrl> m_pendingUrls;
+	int m_resolveTimer;
+
+	static FaviconsCache *m_instance;
+
+signals:
+	void iconsChanged(const QStringList &keys);
+};
+
+}
+
+#endif
@@ -293,6 +293,32 @@ QList<HistoryEntry> HistoryManager::getEntries(bool typed)
 	return entries;
 }
 
+QList<HistoryEntry> HistoryManager::getLocations(QSqlDatabase database)
+{
+	QList<HistoryEntry> entries;
+	QSqlQuery query(database);
+	query.prepare(QLatin1String("SELECT \"visits\".\"location\" AS \"id\", \"visits\".\"title\", \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", MAX(\"visits\".\"time\") AS \"time\", COUNT(\"visits\".\"id\") AS \"visits\", MAX(\"visits\".\"typed\") AS \"typed\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" GROUP BY \"visits\".\"location\";"));
+	query.exec();
+
+	while (query.next())
+	{
+		const QSqlRecord record = query.record();
+		HistoryEntry entry;
+		entry.url = QUrl(record.field(QLatin1String("path")).value().toString());
+		entry.url.setHost(record.field(QLatin1String("host")).value().toString());
+		entry.url.setScheme(record.field(QLatin1String("scheme")).value().toString());
+		entry.title = record.field(QLatin1String("title")).value().toString();
+		entry.time = QDateTime::fromTime_t(record.field(QLatin1String("time")).value().toInt(), Qt::LocalTime);
+		entry.identifier = record.field(QLatin1String("id")).value().toLongLong();
+		entry.visits = record.field(QLatin1String("visits")).value().toInt();
+		entry.typed = record.field(QLatin1String("typed")).value().toBool();
+
+		entries.append(entry);
+	}
+
+	return entries;
+}
+
 qint64 HistoryManager::getRecord(const QLatin1String &table, const QVariantHash &values, bool canCreate)
 {
 	const QStringList keys = values.keys();
@@ -405,6 +431,11 @@ bool HistoryManager::hasUrl(const QUrl &url)
 	return (m_isEnabled && getLocation(url, false) >= 0);
 }
 
+bool HistoryManager::isEnabled()
+{
+	return m_isEnabled;
+}
+
 bool HistoryManager::updateEntry(qint64 entry, const QUrl &url, const QString &title, const QIcon &icon)
 {
 	if (!m_isEnabled || !url.isValid())
@@ -24,6 +24,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtGui/QIcon>
+#include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlRecord>
 
 namespace Otter
@@ -52,8 +53,10 @@ public:
 	static HistoryManager* getInstance();
 	static HistoryEntry getEntry(qint64 entry);
 	static QList<HistoryEntry> getEntries(bool typed = false);
+	static QList<HistoryEntry> getLocations(QSqlDatabase database);
 	static qint64 addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool typed = false);
 	static bool hasUrl(const QUrl &url);
+	static bool isEnabled();
 	static bool updateEntry(qint64 entry, const QUrl &url, const QString &title, const QIcon &icon);
 	static bool removeEntry(qint64 entry);
 	static bool removeEntries(const QList<qint64> &entries);
@@ -0,0 +1,276 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HttpArchive.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QUrlQuery>
+
+namespace Otter
+{
+
+QJsonArray HttpArchive::createHeaders(const QList<QNetworkReply::RawHeaderPair> &headers)
+{
+	QJsonArray array;
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		QJsonObject header;
+		header.insert(QLatin1String("name"), QString::fromLatin1(headers.at(i).first));
+		header.insert(QLatin1String("value"), QString::fromLatin1(headers.at(i).second));
+
+		array.append(header);
+	}
+
+	return array;
+}
+
+QList<QNetworkReply::RawHeaderPair> HttpArchive::parseHeaders(const QJsonArray &array)
+{
+	QList<QNetworkReply::RawHeaderPair> headers;
+
+	for (int i = 0; i < array.count(); ++i)
+	{
+		const QJsonObject header = array.at(i).toObject();
+
+		headers.append(qMakePair(header.value(QLatin1String("name")).toString().toLatin1(), header.value(QLatin1String("value")).toString().toLatin1()));
+	}
+
+	return headers;
+}
+
+QList<HttpArchive::Entry> HttpArchive::load(const QString &path)
+{
+	if (!QFileInfo(path).isDir())
+	{
+		return loadFile(path);
+	}
+
+	const QFileInfoList files = QDir(path).entryInfoList(QStringList(QLatin1String("*.har")), QDir::Files, QDir::Name);
+	QList<Entry> entries;
+
+	for (int i = 0; i < files.count(); ++i)
+	{
+		entries.append(loadFile(files.at(i).absoluteFilePath()));
+	}
+
+	return entries;
+}
+
+QList<HttpArchive::Entry> HttpArchive::loadFile(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QList<Entry>();
+	}
+
+	const QJsonArray entriesArray = QJsonDocument::fromJson(file.readAll()).object().value(QLatin1String("log")).toObject().value(QLatin1String("entries")).toArray();
+	QList<Entry> entries;
+
+	for (int i = 0; i < entriesArray.count(); ++i)
+	{
+		const QJsonObject entryObject = entriesArray.at(i).toObject();
+		const QJsonObject request = entryObject.value(QLatin1String("request")).toObject();
+		const QJsonObject response = entryObject.value(QLatin1String("response")).toObject();
+		const QJsonObject content = response.value(QLatin1String("content")).toObject();
+		const QString text = content.value(QLatin1String("text")).toString();
+		Entry entry;
+		entry.url = QUrl(request.value(QLatin1String("url")).toString());
+		entry.method = request.value(QLatin1String("method")).toString().toLatin1();
+		entry.mimeType = content.value(QLatin1String("mimeType")).toString();
+		entry.body = ((content.value(QLatin1String("encoding")).toString() == QLatin1String("base64")) ? QByteArray::fromBase64(text.toLatin1()) : text.toUtf8());
+		entry.startDateTime = QDateTime::fromString(entryObject.value(QLatin1String("startedDateTime")).toString(), Qt::ISODate);
+		entry.requestHeaders = parseHeaders(request.value(QLatin1String("headers")).toArray());
+		entry.responseHeaders = parseHeaders(response.value(QLatin1String("headers")).toArray());
+		entry.bytesReceived = entry.body.size();
+		entry.status = response.value(QLatin1String("status")).toInt();
+
+		if (entry.url.isValid())
+		{
+			entries.append(entry);
+		}
+	}
+
+	return entries;
+}
+
+QByteArray HttpArchive::getMethod(QNetworkAccessManager::Operation operation, const QNetworkRequest &request)
+{
+	switch (operation)
+	{
+		case QNetworkAccessManager::HeadOperation:
+			return QByteArray("HEAD");
+		case QNetworkAccessManager::GetOperation:
+			return QByteArray("GET");
+		case QNetworkAccessManager::PutOperation:
+			return QByteArray("PUT");
+		case QNetworkAccessManager::PostOperation:
+			return QByteArray("POST");
+		case QNetworkAccessManager::DeleteOperation:
+			return QByteArray("DELETE");
+		case QNetworkAccessManager::CustomOperation:
+			return request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+		default:
+			break;
+	}
+
+	return QByteArray();
+}
+
+bool HttpArchive::save(const QString &path, const QList<Entry> &entries, const QString &title)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	const QString pageIdentifier(QLatin1String("page_1"));
+	QJsonArray entriesArray;
+	qint64 loadTime = 0;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const Entry &entry = entries.at(i);
+		const qint64 startTime = ((entry.startTime < 0) ? entry.queuedTime : entry.startTime);
+		const qint64 firstByteTime = ((entry.firstByteTime < 0) ? startTime : entry.firstByteTime);
+		const qint64 finishTime = ((entry.finishTime < 0) ? firstByteTime : entry.finishTime);
+		QJsonArray queryArray;
+		const QList<QPair<QString, QString> > queryItems = QUrlQuery(entry.url).queryItems(QUrl::FullyDecoded);
+
+		for (int j = 0; j < queryItems.count(); ++j)
+		{
+			QJsonObject queryItem;
+			queryItem.insert(QLatin1String("name"), queryItems.at(j).first);
+			queryItem.insert(QLatin1String("value"), queryItems.at(j).second);
+
+			queryArray.append(queryItem);
+		}
+
+		QJsonObject request;
+		request.insert(QLatin1String("method"), QString::fromLatin1(entry.method));
+		request.insert(QLatin1String("url"), entry.url.toString());
+		request.insert(QLatin1String("httpVersion"), QLatin1String("HTTP/1.1"));
+		request.insert(QLatin1String("cookies"), QJsonArray());
+		request.insert(QLatin1String("headers"), createHeaders(entry.requestHeaders));
+		request.insert(QLatin1String("queryString"), queryArray);
+		request.insert(QLatin1String("headersSize"), -1);
+		request.insert(QLatin1String("bodySize"), -1);
+
+		QJsonObject content;
+		content.insert(QLatin1String("size"), entry.bytesReceived);
+		content.insert(QLatin1String("mimeType"), entry.mimeType);
+
+		if (!entry.body.isEmpty())
+		{
+			content.insert(QLatin1String("text"), QString::fromLatin1(entry.body.toBase64()));
+			content.insert(QLatin1String("encoding"), QLatin1String("base64"));
+		}
+
+		QString redirectUrl;
+
+		for (int j = 0; j < entry.responseHeaders.count(); ++j)
+		{
+			if (entry.responseHeaders.at(j).first.toLower() == "location")
+			{
+				redirectUrl = QString::fromLatin1(entry.responseHeaders.at(j).second);
+
+				break;
+			}
+		}
+
+		QJsonObject response;
+		response.insert(QLatin1String("status"), entry.status);
+		response.insert(QLatin1String("statusText"), QString());
+		response.insert(QLatin1String("httpVersion"), QLatin1String("HTTP/1.1"));
+		response.insert(QLatin1String("cookies"), QJsonArray());
+		response.insert(QLatin1String("headers"), createHeaders(entry.responseHeaders));
+		response.insert(QLatin1String("content"), content);
+		response.insert(QLatin1String("redirectURL"), redirectUrl);
+		response.insert(QLatin1String("headersSize"), -1);
+		response.insert(QLatin1String("bodySize"), (entry.isFromCache ? 0 : entry.bytesReceived));
+
+		QJsonObject timings;
+		timings.insert(QLatin1String("blocked"), (startTime - entry.queuedTime));
+		timings.insert(QLatin1String("dns"), -1);
+		timings.insert(QLatin1String("connect"), -1);
+		timings.insert(QLatin1String("ssl"), -1);
+		timings.insert(QLatin1String("send"), 0);
+		timings.insert(QLatin1String("wait"), (firstByteTime - startTime));
+		timings.insert(QLatin1String("receive"), (finishTime - firstByteTime));
+
+		QJsonObject entryObject;
+		entryObject.insert(QLatin1String("pageref"), pageIdentifier);
+		entryObject.insert(QLatin1String("startedDateTime"), entry.startDateTime.toUTC().toString(Qt::ISODate));
+		entryObject.insert(QLatin1String("time"), (finishTime - entry.queuedTime));
+		entryObject.insert(QLatin1String("request"), request);
+		entryObject.insert(QLatin1String("response"), response);
+		entryObject.insert(QLatin1String("cache"), QJsonObject());
+		entryObject.insert(QLatin1String("timings"), timings);
+
+		if (entry.isBlocked)
+		{
+			entryObject.insert(QLatin1String("comment"), QLatin1String("blocked"));
+		}
+
+		entriesArray.append(entryObject);
+
+		loadTime = qMax(loadTime, finishTime);
+	}
+
+	QJsonObject pageTimings;
+	pageTimings.insert(QLatin1String("onContentLoad"), -1);
+	pageTimings.insert(QLatin1String("onLoad"), (entries.isEmpty() ? -1 : (loadTime - entries.first().queuedTime)));
+
+	QJsonObject page;
+	page.insert(QLatin1String("startedDateTime"), (entries.isEmpty() ? QDateTime::currentDateTimeUtc() : entries.first().startDateTime.toUTC()).toString(Qt::ISODate));
+	page.insert(QLatin1String("id"), pageIdentifier);
+	page.insert(QLatin1String("title"), title);
+	page.insert(QLatin1String("pageTimings"), pageTimings);
+
+	QJsonObject creator;
+	creator.insert(QLatin1String("name"), QCoreApplication::applicationName());
+	creator.insert(QLatin1String("version"), QCoreApplication::applicationVersion());
+
+	QJsonObject log;
+	log.insert(QLatin1String("version"), QLatin1String("1.2"));
+	log.insert(QLatin1String("creator"), creator);
+	QJsonArray pages;
+	pages.append(page);
+
+	log.insert(QLatin1String("pages"), pages);
+	log.insert(QLatin1String("entries"), entriesArray);
+
+	QJsonObject root;
+	root.insert(QLatin1String("log"), log);
+
+	file.write(QJsonDocument(root).toJson());
+
+	return true;
+}
+
+}
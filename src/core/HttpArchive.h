@@ -0,0 +1,68 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HTTPARCHIVE_H
+#define OTTER_HTTPARCHIVE_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonArray>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class HttpArchive
+{
+public:
+	struct Entry
+	{
+		QUrl url;
+		QByteArray method;
+		QString mimeType;
+		QByteArray body;
+		QDateTime startDateTime;
+		QList<QNetworkReply::RawHeaderPair> requestHeaders;
+		QList<QNetworkReply::RawHeaderPair> responseHeaders;
+		qint64 queuedTime;
+		qint64 startTime;
+		qint64 firstByteTime;
+		qint64 finishTime;
+		qint64 bytesReceived;
+		int status;
+		bool isFromCache;
+		bool isBlocked;
+
+		Entry() : queuedTime(0), startTime(-1), firstByteTime(-1), finishTime(-1), bytesReceived(0), status(0), isFromCache(false), isBlocked(false) {}
+	};
+
+	static QList<Entry> load(const QString &path);
+	static QByteArray getMethod(QNetworkAccessManager::Operation operation, const QNetworkRequest &request);
+	static bool save(const QString &path, const QList<Entry> &entries, const QString &title = QString());
+
+protected:
+	static QList<Entry> loadFile(const QString &path);
+	static QList<QNetworkReply::RawHeaderPair> parseHeaders(const QJsonArray &array);
+	static QJsonArray createHeaders(const QList<QNetworkReply::RawHeaderPair> &headers);
+};
+
+}
+
+#endif
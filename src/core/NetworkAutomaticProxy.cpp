@@ -29,6 +29,8 @@
 namespace Otter
 {
 
+QHash<QString, QPair<QHostInfo, qint64> > NetworkAutomaticProxy::m_hosts;
+QStringList NetworkAutomaticProxy::m_unresolvedHosts;
 QStringList NetworkAutomaticProxy::m_months = QStringList() << QLatin1String("jan") << QLatin1String("feb") << QLatin1String("mar") << QLatin1String("apr") << QLatin1String("may") << QLatin1String("jun") << QLatin1String("jul") << QLatin1String("aug") << QLatin1String("sep") << QLatin1String("oct") << QLatin1String("nov") << QLatin1String("dec");
 QStringList NetworkAutomaticProxy::m_days = QStringList() << QLatin1String("mon") << QLatin1String("tue") << QLatin1String("wed") << QLatin1String("thu") << QLatin1String("fri") << QLatin1String("sat") << QLatin1String("sun");
 
@@ -155,7 +157,20 @@ QScriptValue NetworkAutomaticProxy::isInNet(QScriptContext *context, QScriptEngi
 		return context->throwError(QLatin1String("Function isInNet takes three arguments!"));
 	}
 
-	const QHostAddress address(context->argument(0).toString());
+	QHostAddress address(context->argument(0).toString());
+
+	if (address.isNull())
+	{
+		const QHostInfo host = resolveHost(context->argument(0).toString());
+
+		if (host.error() != QHostInfo::NoError || host.addresses().isEmpty())
+		{
+			return false;
+		}
+
+		address = host.addresses().first();
+	}
+
 	const QHostAddress netaddress(context->argument(1).toString());
 	const QHostAddress netmask(context->argument(2).toString());
 
@@ -191,9 +206,9 @@ QScriptValue NetworkAutomaticProxy::dnsResolve(QScriptContext *context, QScriptE
 		return context->throwError(QLatin1String("Function dnsResolve takes only one argument!"));
 	}
 
-	const QHostInfo host = QHostInfo::fromName(context->argument(0).toString());
+	const QHostInfo host = resolveHost(context->argument(0).toString());
 
-	if (host.error() == QHostInfo::NoError)
+	if (host.error() == QHostInfo::NoError && !host.addresses().isEmpty())
 	{
 		return host.addresses().first().toString();
 	}
@@ -222,7 +237,7 @@ QScriptValue NetworkAutomaticProxy::isResolvable(QScriptContext *context, QScrip
 		return context->throwError(QLatin1String("Function isResolvable takes only one argument!"));
 	}
 
-	return (QHostInfo::fromName(context->argument(0).toString()).error() == QHostInfo::NoError);
+	return (resolveHost(context->argument(0).toString()).error() == QHostInfo::NoError);
 }
 
 QScriptValue NetworkAutomaticProxy::localHostOrDomainIs(QScriptContext *context, QScriptEngine *engine)
@@ -459,6 +474,44 @@ bool NetworkAutomaticProxy::setup(const QString &script)
 	return m_findProxy.isFunction();
 }
 
+QHostInfo NetworkAutomaticProxy::resolveHost(const QString &name)
+{
+	if (m_hosts.contains(name) && m_hosts[name].second > QDateTime::currentMSecsSinceEpoch())
+	{
+		return m_hosts[name].first;
+	}
+
+	if (!m_unresolvedHosts.contains(name))
+	{
+		m_unresolvedHosts.append(name);
+	}
+
+	QHostInfo host;
+	host.setHostName(name);
+	host.setError(QHostInfo::UnknownError);
+
+	return host;
+}
+
+void NetworkAutomaticProxy::addHost(const QString &name, const QHostInfo &host)
+{
+	if (m_hosts.count() > 1000)
+	{
+		m_hosts.clear();
+	}
+
+	m_hosts[name] = qMakePair(host, (QDateTime::currentMSecsSinceEpoch() + 60000));
+}
+
+QStringList NetworkAutomaticProxy::takeUnresolvedHosts()
+{
+	const QStringList hosts = m_unresolvedHosts;
+
+	m_unresolvedHosts.clear();
+
+	return hosts;
+}
+
 bool NetworkAutomaticProxy::compareRange(const QVariant &valueOne, const QVariant &valueTwo, const QVariant &actualValue)
 {
 	return (actualValue >= valueOne && actualValue <= valueTwo);
@@ -21,6 +21,7 @@
 #ifndef OTTER_NETWORKAUTOMATICPROXY_H
 #define OTTER_NETWORKAUTOMATICPROXY_H
 
+#include <QtNetwork/QHostInfo>
 #include <QtNetwork/QNetworkProxy>
 #include <QtScript/QScriptEngine>
 #include <QtScript/QScriptValue>
@@ -35,6 +36,8 @@ public:
 
 	QList<QNetworkProxy> getProxy(const QString &url, const QString &host);
 	bool setup(const QString &script);
+	static void addHost(const QString &name, const QHostInfo &host);
+	static QStringList takeUnresolvedHosts();
 
 protected:
 	static QScriptValue alert(QScriptContext *context, QScriptEngine *engine);
@@ -51,6 +54,7 @@ protected:
 	static QScriptValue dateRange(QScriptContext *context, QScriptEngine *engine);
 	static QScriptValue timeRange(QScriptContext *context, QScriptEngine *engine);
 	static QDateTime getDateTime(QScriptContext *context, int *numberOfArguments = NULL);
+	static QHostInfo resolveHost(const QString &name);
 	static bool compareRange(const QVariant &valueOne, const QVariant &valueTwo, const QVariant &actualValue);
 
 private:
@@ -58,6 +62,8 @@ private:
 	QScriptValue m_findProxy;
 	QHash<QString, QList<QNetworkProxy> > m_proxies;
 
+	static QHash<QString, QPair<QHostInfo, qint64> > m_hosts;
+	static QStringList m_unresolvedHosts;
 	static QStringList m_months;
 	static QStringList m_days;
 };
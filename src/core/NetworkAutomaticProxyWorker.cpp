@@ -0,0 +1,157 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkAutomaticProxyWorker.h"
+#include "NetworkAutomaticProxy.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+NetworkAutomaticProxyWorker::NetworkAutomaticProxyWorker(QObject *parent) : QObject(parent),
+	m_automaticProxy(NULL)
+{
+}
+
+NetworkAutomaticProxyWorker::~NetworkAutomaticProxyWorker()
+{
+	QHash<int, QString>::const_iterator iterator;
+
+	for (iterator = m_lookups.constBegin(); iterator != m_lookups.constEnd(); ++iterator)
+	{
+		QHostInfo::abortHostLookup(iterator.key());
+	}
+
+	delete m_automaticProxy;
+}
+
+void NetworkAutomaticProxyWorker::timerEvent(QTimerEvent *event)
+{
+	const int lookup = m_lookupTimers.take(event->timerId());
+
+	killTimer(event->timerId());
+
+	if (!m_lookups.contains(lookup))
+	{
+		return;
+	}
+
+	QHostInfo::abortHostLookup(lookup);
+
+	const QString name = m_lookups.take(lookup);
+	QHostInfo host;
+	host.setHostName(name);
+	host.setError(QHostInfo::UnknownError);
+
+	NetworkAutomaticProxy::addHost(name, host);
+
+	resumeEvaluations(name);
+}
+
+void NetworkAutomaticProxyWorker::handleLookup(const QHostInfo &host)
+{
+	if (!m_lookups.contains(host.lookupId()))
+	{
+		return;
+	}
+
+	const QString name = m_lookups.take(host.lookupId());
+
+	NetworkAutomaticProxy::addHost(name, host);
+
+	resumeEvaluations(name);
+}
+
+void NetworkAutomaticProxyWorker::resumeEvaluations(const QString &name)
+{
+	for (int i = (m_pendingEvaluations.count() - 1); i >= 0; --i)
+	{
+		m_pendingEvaluations[i].hosts.remove(name);
+
+		if (m_pendingEvaluations.at(i).hosts.isEmpty())
+		{
+			const PendingEvaluation evaluation = m_pendingEvaluations.takeAt(i);
+
+			emit proxyEvaluated(evaluation.key, (m_automaticProxy ? m_automaticProxy->getProxy(evaluation.url, evaluation.host) : (QList<QNetworkProxy>() << QNetworkProxy(QNetworkProxy::DefaultProxy))));
+
+			NetworkAutomaticProxy::takeUnresolvedHosts();
+		}
+	}
+}
+
+bool NetworkAutomaticProxyWorker::setup(const QString &script)
+{
+	delete m_automaticProxy;
+
+	m_automaticProxy = new NetworkAutomaticProxy();
+
+	if (!m_automaticProxy->setup(script))
+	{
+		delete m_automaticProxy;
+
+		m_automaticProxy = NULL;
+
+		return false;
+	}
+
+	return true;
+}
+
+void NetworkAutomaticProxyWorker::evaluate(const QString &url, const QString &host, const QString &key)
+{
+	if (!m_automaticProxy)
+	{
+		emit proxyEvaluated(key, QList<QNetworkProxy>() << QNetworkProxy(QNetworkProxy::DefaultProxy));
+
+		return;
+	}
+
+	const QList<QNetworkProxy> proxies = m_automaticProxy->getProxy(url, host);
+	const QStringList hosts = NetworkAutomaticProxy::takeUnresolvedHosts();
+
+	if (hosts.isEmpty())
+	{
+		emit proxyEvaluated(key, proxies);
+
+		return;
+	}
+
+// script needs names that are not resolved yet, look them up in background and evaluate it again once all of them are known
+	PendingEvaluation evaluation;
+	evaluation.url = url;
+	evaluation.host = host;
+	evaluation.key = key;
+	evaluation.hosts = hosts.toSet();
+
+	m_pendingEvaluations.append(evaluation);
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		if (!m_lookups.values().contains(hosts.at(i)))
+		{
+			const int lookup = QHostInfo::lookupHost(hosts.at(i), this, SLOT(handleLookup(QHostInfo)));
+
+			m_lookups[lookup] = hosts.at(i);
+			m_lookupTimers[startTimer(3000)] = lookup;
+		}
+	}
+}
+
+}
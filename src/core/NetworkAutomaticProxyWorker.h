@@ -0,0 +1,72 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKAUTOMATICPROXYWORKER_H
+#define OTTER_NETWORKAUTOMATICPROXYWORKER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtNetwork/QHostInfo>
+#include <QtNetwork/QNetworkProxy>
+
+namespace Otter
+{
+
+class NetworkAutomaticProxy;
+
+class NetworkAutomaticProxyWorker : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkAutomaticProxyWorker(QObject *parent = NULL);
+	~NetworkAutomaticProxyWorker();
+
+public slots:
+	bool setup(const QString &script);
+	void evaluate(const QString &url, const QString &host, const QString &key);
+
+protected:
+	struct PendingEvaluation
+	{
+		QString url;
+		QString host;
+		QString key;
+		QSet<QString> hosts;
+	};
+
+	void timerEvent(QTimerEvent *event);
+	void resumeEvaluations(const QString &name);
+
+protected slots:
+	void handleLookup(const QHostInfo &host);
+
+private:
+	NetworkAutomaticProxy *m_automaticProxy;
+	QList<PendingEvaluation> m_pendingEvaluations;
+	QHash<int, QString> m_lookups;
+	QHash<int, int> m_lookupTimers;
+
+signals:
+	void proxyEvaluated(const QString &key, const QList<QNetworkProxy> &proxies);
+};
+
+}
+
+#endif
@@ -18,17 +18,36 @@
 **************************************************************************/
 
 #include "NetworkCache.h"
+#include "Console.h"
+#include "NetworkCacheDevice.h"
+#include "NetworkCacheWorker.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QTimerEvent>
+#include <QtNetwork/QNetworkReply>
 
 namespace Otter
 {
 
-NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
+NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent),
+	m_thread(NULL),
+	m_worker(NULL),
+	m_memoryHits(0),
+	m_diskHits(0),
+	m_misses(0),
+	m_readIdentifier(0),
+	m_expirationTimer(0),
+	m_compressEntries(SettingsManager::getValue(QLatin1String("Cache/CompressEntries")).toBool())
 {
+	m_memoryCache.setMaxCost(SettingsManager::getValue(QLatin1String("Cache/MemoryCacheLimit")).toInt() * 1024);
+
 	const QString cachePath = SessionsManager::getCachePath();
 
 	if (!cachePath.isEmpty())
@@ -37,11 +56,65 @@ NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
 
 		setCacheDirectory(cachePath);
 		setMaximumCacheSize(SettingsManager::getValue(QLatin1String("Cache/DiskCacheLimit")).toInt() * 1024);
+
+		qRegisterMetaType<NetworkCacheIndex>("NetworkCacheIndex");
+		qRegisterMetaType<NetworkCacheIndex::Entry>("NetworkCacheIndex::Entry");
+		qRegisterMetaType<QList<NetworkCacheIndex::Entry> >("QList<NetworkCacheIndex::Entry>");
+		qRegisterMetaType<QList<QUrl> >("QList<QUrl>");
+		qRegisterMetaType<QNetworkCacheMetaData>("QNetworkCacheMetaData");
+
+		m_thread = new QThread(this);
+		m_worker = new NetworkCacheWorker(cacheDirectory());
+		m_worker->moveToThread(m_thread);
+		m_thread->start();
+
+		connect(this, SIGNAL(requestedWrite(QNetworkCacheMetaData,QByteArray)), m_worker, SLOT(writeEntry(QNetworkCacheMetaData,QByteArray)));
+		connect(this, SIGNAL(requestedUpdate(QNetworkCacheMetaData)), m_worker, SLOT(updateEntry(QNetworkCacheMetaData)));
+		connect(this, SIGNAL(requestedRead(int,NetworkCacheIndex::Entry)), m_worker, SLOT(readEntry(int,NetworkCacheIndex::Entry)));
+		connect(this, SIGNAL(requestedRemoval(QList<QUrl>)), m_worker, SLOT(removeEntries(QList<QUrl>)));
+		connect(this, SIGNAL(requestedClear()), m_worker, SLOT(clearEntries()));
+		connect(this, SIGNAL(requestedScan()), m_worker, SLOT(scanEntries()));
+		connect(this, SIGNAL(requestedSynchronization(QList<NetworkCacheIndex::Entry>)), m_worker, SLOT(setEntries(QList<NetworkCacheIndex::Entry>)));
+		connect(m_worker, SIGNAL(entryWritten(NetworkCacheIndex::Entry)), this, SLOT(addEntry(NetworkCacheIndex::Entry)));
+		connect(m_worker, SIGNAL(entriesScanned(QList<NetworkCacheIndex::Entry>)), this, SLOT(addEntries(QList<NetworkCacheIndex::Entry>)));
+		connect(m_worker, SIGNAL(entryDataRead(int,QByteArray)), this, SLOT(appendEntryData(int,QByteArray)));
+		connect(m_worker, SIGNAL(entryRead(int,QUrl,QByteArray,bool)), this, SLOT(setEntryData(int,QUrl,QByteArray,bool)));
+
+		if (m_index.load(getIndexPath()))
+		{
+			emit requestedSynchronization(m_index.getEntries());
+		}
+		else
+		{
+			emit requestedScan();
+		}
+
+		QFile::remove(getIndexPath());
 	}
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 }
 
+NetworkCache::~NetworkCache()
+{
+	qDeleteAll(m_devices.keys());
+
+	if (!m_thread)
+	{
+		return;
+	}
+
+	// wait for queued writes and apply their results before index is saved
+	QMetaObject::invokeMethod(m_worker, "synchronize", Qt::BlockingQueuedConnection);
+	QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+	QMetaObject::invokeMethod(m_worker, "saveIndex", Qt::BlockingQueuedConnection, Q_ARG(NetworkCacheIndex, m_index));
+
+	m_thread->quit();
+	m_thread->wait();
+
+	delete m_worker;
+}
+
 void NetworkCache::clearCache(int period)
 {
 	if (period <= 0)
@@ -53,127 +126,511 @@ void NetworkCache::clearCache(int period)
 		return;
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	const QDateTime threshold = QDateTime::currentDateTimeUtc().addSecs(-(period * 3600));
+	const QList<NetworkCacheIndex::Entry> entries = m_index.getEntries();
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (entries.at(i).timeStored >= threshold)
+		{
+			remove(entries.at(i).url);
+		}
+	}
+}
+
+void NetworkCache::clear()
+{
+	m_index.clear();
+	m_memoryCache.clear();
+
+	emit requestedClear();
+}
+
+void NetworkCache::addEntry(const NetworkCacheIndex::Entry &entry)
+{
+	m_index.addEntry(entry);
+
+	emit entryAdded(entry.url);
 
-	for (int i = 0; i < directories.count(); ++i)
+	if (m_index.getTotalSize() > maximumCacheSize())
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories = cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+		expire();
+	}
+}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+void NetworkCache::addEntries(const QList<NetworkCacheIndex::Entry> &entries)
+{
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (!m_index.hasEntry(entries.at(i).url))
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+			m_index.addEntry(entries.at(i));
+		}
+	}
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k)));
+	if (m_index.getTotalSize() > maximumCacheSize())
+	{
+		expire();
+	}
+}
 
-				if (metaData.isValid() && metaData.lastModified().isValid() && metaData.lastModified().secsTo(QDateTime::currentDateTime()) > (period * 3600))
-				{
-					remove(metaData.url());
-				}
+void NetworkCache::appendEntryData(int identifier, const QByteArray &data)
+{
+	const QPointer<NetworkCacheDevice> device = m_readDevices.value(identifier);
+
+	if (device)
+	{
+		device->appendData(data);
+	}
+}
+
+void NetworkCache::setEntryData(int identifier, const QUrl &url, const QByteArray &data, bool isSuccess)
+{
+	const QPointer<NetworkCacheDevice> device = m_readDevices.take(identifier);
+
+	if (!isSuccess)
+	{
+		remove(url);
+
+		if (device)
+		{
+			QNetworkReply *reply = qobject_cast<QNetworkReply*>(device->parent());
+
+			if (reply)
+			{
+				reply->abort();
+			}
+			else
+			{
+				device->appendData(QByteArray(), true);
 			}
 		}
+
+		return;
+	}
+
+	if (m_index.hasEntry(url) && m_index.getEntry(url).dataSize == data.size())
+	{
+		addMemoryEntry(m_index.getEntry(url).metaData, data);
+	}
+
+	if (device)
+	{
+		device->appendData(data, true);
 	}
 }
 
 void NetworkCache::insert(QIODevice *device)
 {
-	QNetworkDiskCache::insert(device);
+	if (!m_devices.contains(device))
+	{
+		return;
+	}
+
+	QNetworkCacheMetaData metaData = m_devices.take(device);
+	const QByteArray data = qobject_cast<QBuffer*>(device)->data();
+
+	delete device;
+
+	if (data.size() > ((maximumCacheSize() * 3) / 4))
+	{
+		return;
+	}
+
+	NetworkCacheIndex::setCompressed(metaData, (m_compressEntries && NetworkCacheIndex::isCompressible(metaData, data.size())));
+
+	addMemoryEntry(metaData, data);
+
+	emit requestedWrite(metaData, data);
+}
+
+void NetworkCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+	if (!metaData.isValid())
+	{
+		return;
+	}
+
+	QNetworkCacheMetaData updatedMetaData(metaData);
+	MemoryEntry *memoryEntry = m_memoryCache.object(metaData.url());
+
+	if (memoryEntry)
+	{
+		NetworkCacheIndex::setCompressed(updatedMetaData, NetworkCacheIndex::isCompressed(memoryEntry->metaData));
+
+		memoryEntry->metaData = updatedMetaData;
+	}
 
-	if (m_devices.contains(device))
+	if (m_index.hasEntry(metaData.url()))
 	{
-		emit entryAdded(m_devices[device]);
+		const NetworkCacheIndex::Entry entry = m_index.getEntry(metaData.url());
+
+		NetworkCacheIndex::setCompressed(updatedMetaData, entry.isCompressed);
+		NetworkCacheIndex::setBlob(updatedMetaData, entry.blob);
 
-		m_devices.remove(device);
+		NetworkCacheIndex::Entry updatedEntry = NetworkCacheIndex::createEntry(updatedMetaData, entry.path, entry.size, entry.timeStored);
+		updatedEntry.blobSize = entry.blobSize;
+		updatedEntry.dataSize = entry.dataSize;
+
+		m_index.addEntry(updatedEntry);
 	}
+
+	emit requestedUpdate(updatedMetaData);
 }
 
 QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
 {
-	QIODevice *device = QNetworkDiskCache::prepare(metaData);
+	if (!m_worker || !metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk())
+	{
+		return NULL;
+	}
 
-	if (device)
+	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.toLower() == "content-length" && headers.at(i).second.toLongLong() > ((maximumCacheSize() * 3) / 4))
+		{
+			return NULL;
+		}
+	}
+
+	QBuffer *buffer = new QBuffer();
+	buffer->open(QIODevice::ReadWrite);
+
+	m_devices[buffer] = metaData;
+
+	return buffer;
+}
+
+QIODevice* NetworkCache::data(const QUrl &url)
+{
+	QByteArray data;
+	MemoryEntry *memoryEntry = m_memoryCache.object(url);
+
+	if (memoryEntry)
+	{
+		data = memoryEntry->data;
+	}
+	else
+	{
+		if (!m_index.hasEntry(url))
+		{
+			return NULL;
+		}
+
+		const NetworkCacheIndex::Entry entry = m_index.getEntry(url);
+
+		// empty bodies never emit readyRead(), so they are served without touching disk
+		if (entry.dataSize != 0)
+		{
+			++m_readIdentifier;
+
+			NetworkCacheDevice *device = new NetworkCacheDevice();
+
+			m_readDevices[m_readIdentifier] = device;
+
+			emit requestedRead(m_readIdentifier, entry);
+
+			return device;
+		}
+	}
+
+	QBuffer *buffer = new QBuffer();
+	buffer->setData(data);
+	buffer->open(QIODevice::ReadOnly);
+
+	return buffer;
+}
+
+QNetworkCacheMetaData NetworkCache::metaData(const QUrl &url)
+{
+	MemoryEntry *memoryEntry = m_memoryCache.object(url);
+
+	if (memoryEntry)
 	{
-		m_devices[device] = metaData.url();
+		++m_memoryHits;
+		++m_hostStatistics[url.host()].hits;
+
+		m_index.markAccessed(url);
+
+		return memoryEntry->metaData;
+	}
+
+	if (!m_index.hasEntry(url))
+	{
+		++m_misses;
+		++m_hostStatistics[url.host()].misses;
+
+		return QNetworkCacheMetaData();
+	}
+
+	const QNetworkCacheMetaData metaData = m_index.getEntry(url).metaData;
+
+	if (metaData.isValid())
+	{
+		++m_diskHits;
+		++m_hostStatistics[url.host()].hits;
+
+		m_index.markAccessed(url);
+	}
+	else
+	{
+		++m_misses;
+		++m_hostStatistics[url.host()].misses;
+	}
+
+	return metaData;
+}
+
+QIODevice* NetworkCache::getEntryData(const QUrl &url)
+{
+	if (m_index.hasEntry(url))
+	{
+		QIODevice *device = readEntry(m_index.getEntry(url));
+
+		if (device)
+		{
+			return device;
+		}
+	}
+
+	if (!m_memoryCache.contains(url))
+	{
+		return NULL;
 	}
 
-	return device;
+	QBuffer *buffer = new QBuffer();
+	buffer->setData(m_memoryCache.object(url)->data);
+	buffer->open(QIODevice::ReadOnly);
+
+	return buffer;
 }
 
 QString NetworkCache::getPathForUrl(const QUrl &url)
 {
-	if (!url.isValid() || !metaData(url).isValid())
+	if (!url.isValid() || !m_index.hasEntry(url))
 	{
 		return QString();
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	const NetworkCacheIndex::Entry entry = m_index.getEntry(url);
+
+	if (!entry.blob.isEmpty() || !entry.path.isEmpty())
+	{
+		const QString path = cacheDirectory() + (entry.blob.isEmpty() ? entry.path : NetworkCacheIndex::getBlobPath(entry.blob));
 
-	for (int i = 0; i < directories.count(); ++i)
+		if (QFile::exists(path))
+		{
+			return path;
+		}
+	}
+	else
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories = cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+		QDirIterator iterator(cacheDirectory(), QStringList(QLatin1String("*.d")), QDir::Files, QDirIterator::Subdirectories);
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+		while (iterator.hasNext())
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+			iterator.next();
 
-			for (int k = 0; k < files.count(); ++k)
+			if (fileMetaData(iterator.filePath()).url() == url)
 			{
-				const QString cacheFilePath = cacheFilesDirectory.absoluteFilePath(files.at(k));
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilePath);
-
-				if (metaData.isValid() && url == metaData.url())
-				{
-					return cacheFilePath;
-				}
+				return iterator.filePath();
 			}
 		}
 	}
 
+	Console::addMessage(tr("Cache file for %1 is missing").arg(url.toDisplayString()), NetworkMessageCategory, WarningMessageLevel);
+
 	return QString();
 }
 
+QString NetworkCache::getIndexPath() const
+{
+	return cacheDirectory() + QLatin1String("index.dat");
+}
+
 QList<QUrl> NetworkCache::getEntries() const
 {
-	QList<QUrl> entries;
+	return m_index.getUrls();
+}
+
+NetworkCacheIndex NetworkCache::getIndex() const
+{
+	return m_index;
+}
+
+NetworkCacheIndex::Entry NetworkCache::getEntry(const QUrl &url) const
+{
+	return m_index.getEntry(url);
+}
+
+QHash<QString, NetworkCache::HostStatistics> NetworkCache::getHostStatistics() const
+{
+	const qint64 now = (QDateTime::currentMSecsSinceEpoch() / 1000);
+	const QHash<QString, NetworkCacheIndex::HostInformation> hosts = m_index.getHosts();
+	QHash<QString, HostStatistics> statistics = m_hostStatistics;
+	QHash<QString, NetworkCacheIndex::HostInformation>::const_iterator iterator;
+
+	for (iterator = hosts.constBegin(); iterator != hosts.constEnd(); ++iterator)
+	{
+		HostStatistics &hostStatistics = statistics[iterator.key()];
+		hostStatistics.size = iterator.value().size;
+		hostStatistics.entries = iterator.value().entries;
+		hostStatistics.averageAge = (now - (iterator.value().timeStored / iterator.value().entries));
+	}
+
+	return statistics;
+}
+
+qint64 NetworkCache::cacheSize() const
+{
+	return m_index.getTotalSize();
+}
+
+qreal NetworkCache::getDeduplicationRatio() const
+{
+	return ((m_index.getTotalSize() > 0) ? ((qreal) m_index.getLogicalSize() / m_index.getTotalSize()) : 1);
+}
+
+qint64 NetworkCache::getMemoryHitsAmount() const
+{
+	return m_memoryHits;
+}
+
+qint64 NetworkCache::getDiskHitsAmount() const
+{
+	return m_diskHits;
+}
+
+qint64 NetworkCache::getMissesAmount() const
+{
+	return m_misses;
+}
+
+void NetworkCache::addMemoryEntry(const QNetworkCacheMetaData &metaData, const QByteArray &data)
+{
+	if (!metaData.isValid() || data.size() > (m_memoryCache.maxCost() / 8))
+	{
+		return;
+	}
+
+	MemoryEntry *memoryEntry = new MemoryEntry();
+	memoryEntry->metaData = metaData;
+	memoryEntry->data = data;
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories = cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	m_memoryCache.insert(metaData.url(), memoryEntry, (data.size() + 1024));
+}
+
+QIODevice* NetworkCache::readEntry(const NetworkCacheIndex::Entry &entry)
+{
+	QIODevice *device = NULL;
 
-	for (int i = 0; i < directories.count(); ++i)
+	if (entry.blob.isEmpty())
+	{
+		device = QNetworkDiskCache::data(entry.url);
+	}
+	else
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories = cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+		device = new QFile(cacheDirectory() + NetworkCacheIndex::getBlobPath(entry.blob));
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+		if (!device->open(QIODevice::ReadOnly))
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files = cacheFilesDirectory.entryList(QDir::Files);
+			delete device;
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData = fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k)));
+			return NULL;
+		}
+	}
 
-				if (metaData.url().isValid())
-				{
-					entries.append(metaData.url());
-				}
-			}
+	if (!device || !entry.isCompressed)
+	{
+		return device;
+	}
+
+	QBuffer *buffer = new QBuffer();
+	buffer->setData(qUncompress(device->readAll()));
+	buffer->open(QIODevice::ReadOnly);
+
+	delete device;
+
+	return buffer;
+}
+
+void NetworkCache::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_expirationTimer)
+	{
+		const qint64 limit = ((maximumCacheSize() * 9) / 10);
+		const QList<QUrl> candidates = m_index.getEvictionCandidates(32);
+		QList<QUrl> urls;
+
+		for (int i = 0; (i < candidates.count() && m_index.getTotalSize() > limit); ++i)
+		{
+			m_index.evictEntry(candidates.at(i));
+			m_memoryCache.remove(candidates.at(i));
+
+			++m_hostStatistics[candidates.at(i).host()].evictions;
+
+			urls.append(candidates.at(i));
+
+			emit entryRemoved(candidates.at(i));
 		}
+
+		if (!urls.isEmpty())
+		{
+			emit requestedRemoval(urls);
+		}
+
+		if (candidates.isEmpty() || m_index.getTotalSize() <= limit)
+		{
+			killTimer(m_expirationTimer);
+
+			m_expirationTimer = 0;
+		}
+	}
+}
+
+qint64 NetworkCache::expire()
+{
+	if (maximumCacheSize() <= 0)
+	{
+		clear();
+
+		return 0;
+	}
+
+	if (m_index.getTotalSize() > maximumCacheSize() && m_expirationTimer == 0)
+	{
+		m_expirationTimer = startTimer(0);
 	}
 
-	return entries;
+	return m_index.getTotalSize();
 }
 
 bool NetworkCache::remove(const QUrl &url)
 {
-	const bool result = QNetworkDiskCache::remove(url);
+	QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator = m_devices.begin();
+
+	while (iterator != m_devices.end())
+	{
+		if (iterator.value().url() == url)
+		{
+			delete iterator.key();
+
+			iterator = m_devices.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const bool result = (m_index.hasEntry(url) || m_memoryCache.contains(url));
+
+	m_index.removeEntry(url);
+	m_memoryCache.remove(url);
+
+	emit requestedRemoval(QList<QUrl>() << url);
 
 	if (result)
 	{
@@ -189,6 +646,14 @@ void NetworkCache::optionChanged(const QString &option, const QVariant &value)
 	{
 		setMaximumCacheSize(value.toInt() * 1024);
 	}
+	else if (option == QLatin1String("Cache/MemoryCacheLimit"))
+	{
+		m_memoryCache.setMaxCost(value.toInt() * 1024);
+	}
+	else if (option == QLatin1String("Cache/CompressEntries"))
+	{
+		m_compressEntries = value.toBool();
+	}
 }
 
 }
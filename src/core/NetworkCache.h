@@ -20,32 +20,104 @@
 #ifndef OTTER_NETWORKCACHE_H
 #define OTTER_NETWORKCACHE_H
 
+#include "NetworkCacheIndex.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
 #include <QtNetwork/QNetworkDiskCache>
 
 namespace Otter
 {
 
+class NetworkCacheDevice;
+class NetworkCacheWorker;
+
 class NetworkCache : public QNetworkDiskCache
 {
 	Q_OBJECT
 
 public:
+	struct HostStatistics
+	{
+		qint64 hits;
+		qint64 misses;
+		qint64 evictions;
+		qint64 size;
+		qint64 averageAge;
+		int entries;
+
+		HostStatistics() : hits(0), misses(0), evictions(0), size(0), averageAge(0), entries(0) {}
+	};
+
 	explicit NetworkCache(QObject *parent = NULL);
+	~NetworkCache();
 
 	void clearCache(int period = 0);
 	void insert(QIODevice *device);
+	void updateMetaData(const QNetworkCacheMetaData &metaData);
 	QIODevice* prepare(const QNetworkCacheMetaData &metaData);
+	QIODevice* data(const QUrl &url);
+	QNetworkCacheMetaData metaData(const QUrl &url);
+	QIODevice* getEntryData(const QUrl &url);
 	QString getPathForUrl(const QUrl &url);
 	QList<QUrl> getEntries() const;
+	NetworkCacheIndex getIndex() const;
+	NetworkCacheIndex::Entry getEntry(const QUrl &url) const;
+	QHash<QString, HostStatistics> getHostStatistics() const;
+	qint64 cacheSize() const;
+	qreal getDeduplicationRatio() const;
+	qint64 getMemoryHitsAmount() const;
+	qint64 getDiskHitsAmount() const;
+	qint64 getMissesAmount() const;
 	bool remove(const QUrl &url);
 
+public slots:
+	void clear();
+
+protected:
+	struct MemoryEntry
+	{
+		QNetworkCacheMetaData metaData;
+		QByteArray data;
+	};
+
+	void timerEvent(QTimerEvent *event);
+	qint64 expire();
+	void addMemoryEntry(const QNetworkCacheMetaData &metaData, const QByteArray &data);
+	QIODevice* readEntry(const NetworkCacheIndex::Entry &entry);
+	QString getIndexPath() const;
+
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
+	void addEntry(const NetworkCacheIndex::Entry &entry);
+	void addEntries(const QList<NetworkCacheIndex::Entry> &entries);
+	void appendEntryData(int identifier, const QByteArray &data);
+	void setEntryData(int identifier, const QUrl &url, const QByteArray &data, bool isSuccess);
 
 private:
-	QHash<QIODevice*, QUrl> m_devices;
+	QThread *m_thread;
+	NetworkCacheWorker *m_worker;
+	NetworkCacheIndex m_index;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QHash<int, QPointer<NetworkCacheDevice> > m_readDevices;
+	QCache<QUrl, MemoryEntry> m_memoryCache;
+	QHash<QString, HostStatistics> m_hostStatistics;
+	qint64 m_memoryHits;
+	qint64 m_diskHits;
+	qint64 m_misses;
+	int m_readIdentifier;
+	int m_expirationTimer;
+	bool m_compressEntries;
 
 signals:
+	void requestedWrite(const QNetworkCacheMetaData &metaData, const QByteArray &data);
+	void requestedUpdate(const QNetworkCacheMetaData &metaData);
+	void requestedRead(int identifier, const NetworkCacheIndex::Entry &entry);
+	void requestedRemoval(const QList<QUrl> &urls);
+	void requestedClear();
+	void requestedScan();
+	void requestedSynchronization(const QList<NetworkCacheIndex::Entry> &entries);
 	void cleared();
 	void entryAdded(QUrl url);
 	void entryRemoved(QUrl url);
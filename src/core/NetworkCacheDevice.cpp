@@ -0,0 +1,103 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkCacheDevice.h"
+
+namespace Otter
+{
+
+NetworkCacheDevice::NetworkCacheDevice(QObject *parent) : QIODevice(parent),
+	m_offset(0),
+	m_isFinished(false)
+{
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void NetworkCacheDevice::appendData(const QByteArray &data, bool isFinished)
+{
+	if (m_isFinished)
+	{
+		return;
+	}
+
+	if (m_offset < m_data.size())
+	{
+		m_data.append(data);
+	}
+	else
+	{
+		m_data = data;
+		m_offset = 0;
+	}
+
+	m_isFinished = isFinished;
+
+	emit readyRead();
+
+	if (isFinished)
+	{
+		emit readChannelFinished();
+	}
+}
+
+qint64 NetworkCacheDevice::bytesAvailable() const
+{
+	return ((m_data.size() - m_offset) + QIODevice::bytesAvailable());
+}
+
+qint64 NetworkCacheDevice::readData(char *data, qint64 maxSize)
+{
+	if (!m_isFinished)
+	{
+		return 0;
+	}
+
+	if (m_offset < m_data.size())
+	{
+		const qint64 number = qMin(maxSize, (m_data.size() - m_offset));
+
+		memcpy(data, (m_data.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+qint64 NetworkCacheDevice::writeData(const char *data, qint64 maxSize)
+{
+	Q_UNUSED(data)
+	Q_UNUSED(maxSize)
+
+	return -1;
+}
+
+bool NetworkCacheDevice::atEnd() const
+{
+	return (m_isFinished && bytesAvailable() == 0);
+}
+
+bool NetworkCacheDevice::isSequential() const
+{
+	return true;
+}
+
+}
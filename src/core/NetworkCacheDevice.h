@@ -0,0 +1,52 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKCACHEDEVICE_H
+#define OTTER_NETWORKCACHEDEVICE_H
+
+#include <QtCore/QIODevice>
+
+namespace Otter
+{
+
+class NetworkCacheDevice : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkCacheDevice(QObject *parent = NULL);
+
+	void appendData(const QByteArray &data, bool isFinished = false);
+	qint64 bytesAvailable() const;
+	bool atEnd() const;
+	bool isSequential() const;
+
+protected:
+	qint64 readData(char *data, qint64 maxSize);
+	qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+	QByteArray m_data;
+	qint64 m_offset;
+	bool m_isFinished;
+};
+
+}
+
+#endif
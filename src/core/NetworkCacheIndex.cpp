@@ -0,0 +1,483 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkCacheIndex.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+NetworkCacheIndex::NetworkCacheIndex() : m_totalSize(0),
+	m_logicalSize(0),
+	m_inflation(0)
+{
+}
+
+void NetworkCacheIndex::addEntry(const Entry &entry)
+{
+	Entry indexedEntry(entry);
+
+	if (indexedEntry.hits <= 0)
+	{
+		const QHash<QUrl, Entry>::const_iterator iterator = m_entries.constFind(indexedEntry.url);
+
+		if (iterator == m_entries.constEnd())
+		{
+			indexedEntry.hits = 1;
+			indexedEntry.lastAccess = indexedEntry.timeStored;
+		}
+		else
+		{
+			indexedEntry.hits = iterator.value().hits;
+			indexedEntry.lastAccess = iterator.value().lastAccess;
+		}
+	}
+
+	if (!indexedEntry.timeStored.isValid())
+	{
+		indexedEntry.timeStored = QDateTime::currentDateTimeUtc();
+	}
+
+	indexedEntry.priority = getPriority(indexedEntry);
+
+	removeEntry(indexedEntry.url);
+
+	m_entries[indexedEntry.url] = indexedEntry;
+
+	addCandidate(indexedEntry);
+
+	m_totalSize += indexedEntry.size;
+	m_logicalSize += (indexedEntry.size + indexedEntry.blobSize);
+
+	HostInformation &host = m_hosts[indexedEntry.url.host()];
+	host.size += (indexedEntry.size + indexedEntry.blobSize);
+	host.timeStored += (indexedEntry.timeStored.toMSecsSinceEpoch() / 1000);
+
+	++host.entries;
+
+	if (!indexedEntry.blob.isEmpty())
+	{
+		BlobInformation &blob = m_blobs[indexedEntry.blob];
+
+		if (blob.references == 0)
+		{
+			blob.size = indexedEntry.blobSize;
+
+			m_totalSize += indexedEntry.blobSize;
+		}
+
+		++blob.references;
+	}
+}
+
+void NetworkCacheIndex::removeEntry(const QUrl &url)
+{
+	QHash<QUrl, Entry>::iterator iterator = m_entries.find(url);
+
+	if (iterator == m_entries.end())
+	{
+		return;
+	}
+
+	m_totalSize -= iterator.value().size;
+	m_logicalSize -= (iterator.value().size + iterator.value().blobSize);
+
+	const QString hostName = iterator.value().url.host();
+	HostInformation &host = m_hosts[hostName];
+	host.size -= (iterator.value().size + iterator.value().blobSize);
+	host.timeStored -= (iterator.value().timeStored.toMSecsSinceEpoch() / 1000);
+
+	--host.entries;
+
+	if (host.entries <= 0)
+	{
+		m_hosts.remove(hostName);
+	}
+
+	if (!iterator.value().blob.isEmpty() && m_blobs.contains(iterator.value().blob))
+	{
+		BlobInformation &blob = m_blobs[iterator.value().blob];
+		--blob.references;
+
+		if (blob.references <= 0)
+		{
+			m_totalSize -= blob.size;
+
+			m_blobs.remove(iterator.value().blob);
+		}
+	}
+
+	removeCandidate(iterator.value());
+
+	m_entries.erase(iterator);
+}
+
+void NetworkCacheIndex::evictEntry(const QUrl &url)
+{
+	const QHash<QUrl, Entry>::const_iterator iterator = m_entries.constFind(url);
+
+	if (iterator != m_entries.constEnd())
+	{
+		m_inflation = qMax(m_inflation, iterator.value().priority);
+
+		removeEntry(url);
+	}
+}
+
+void NetworkCacheIndex::markAccessed(const QUrl &url)
+{
+	QHash<QUrl, Entry>::iterator iterator = m_entries.find(url);
+
+	if (iterator != m_entries.end())
+	{
+		removeCandidate(iterator.value());
+
+		++iterator.value().hits;
+
+		iterator.value().lastAccess = QDateTime::currentDateTimeUtc();
+		iterator.value().priority = getPriority(iterator.value());
+
+		addCandidate(iterator.value());
+	}
+}
+
+void NetworkCacheIndex::clear()
+{
+	m_entries.clear();
+	m_blobs.clear();
+	m_hosts.clear();
+	m_priorities.clear();
+	m_expirations.clear();
+
+	m_totalSize = 0;
+	m_logicalSize = 0;
+	m_inflation = 0;
+}
+
+NetworkCacheIndex::Entry NetworkCacheIndex::getEntry(const QUrl &url) const
+{
+	return m_entries.value(url);
+}
+
+QList<NetworkCacheIndex::Entry> NetworkCacheIndex::getEntries() const
+{
+	return m_entries.values();
+}
+
+QList<QUrl> NetworkCacheIndex::getUrls() const
+{
+	return m_entries.keys();
+}
+
+QList<QUrl> NetworkCacheIndex::getEvictionCandidates(int amount) const
+{
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+	QList<QUrl> urls;
+	QList<QUrl> sharedUrls;
+	QMultiMap<QDateTime, QUrl>::const_iterator expirationsIterator;
+
+	for (expirationsIterator = m_expirations.constBegin(); (expirationsIterator != m_expirations.constEnd() && expirationsIterator.key() <= now && urls.count() < amount); ++expirationsIterator)
+	{
+		urls.append(expirationsIterator.value());
+	}
+
+	QMultiMap<qreal, QUrl>::const_iterator prioritiesIterator;
+
+	for (prioritiesIterator = m_priorities.constBegin(); (prioritiesIterator != m_priorities.constEnd() && urls.count() < amount); ++prioritiesIterator)
+	{
+		const Entry entry = m_entries.value(prioritiesIterator.value());
+
+		if (entry.expirationDate.isValid() && entry.expirationDate <= now)
+		{
+			continue;
+		}
+
+		if (isShared(entry))
+		{
+			if (sharedUrls.count() < amount)
+			{
+				sharedUrls.append(entry.url);
+			}
+
+			continue;
+		}
+
+		urls.append(entry.url);
+	}
+
+	return (urls.isEmpty() ? sharedUrls : urls);
+}
+
+QHash<QString, NetworkCacheIndex::HostInformation> NetworkCacheIndex::getHosts() const
+{
+	return m_hosts;
+}
+
+qint64 NetworkCacheIndex::getTotalSize() const
+{
+	return m_totalSize;
+}
+
+qint64 NetworkCacheIndex::getLogicalSize() const
+{
+	return m_logicalSize;
+}
+
+int NetworkCacheIndex::getEntriesAmount() const
+{
+	return m_entries.count();
+}
+
+bool NetworkCacheIndex::hasEntry(const QUrl &url) const
+{
+	return m_entries.contains(url);
+}
+
+bool NetworkCacheIndex::load(const QString &path)
+{
+	clear();
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	quint32 magic;
+	quint32 version;
+	quint32 amount;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4f4e4349 || version != 5)
+	{
+		return false;
+	}
+
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream >> m_inflation >> amount;
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		Entry entry;
+
+		stream >> entry.metaData >> entry.path >> entry.type >> entry.lastModified >> entry.expirationDate >> entry.timeStored >> entry.lastAccess >> entry.blob >> entry.size >> entry.blobSize >> entry.dataSize >> entry.hits >> entry.isCompressed;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			clear();
+
+			return false;
+		}
+
+		entry.url = entry.metaData.url();
+
+		addEntry(entry);
+	}
+
+	return true;
+}
+
+bool NetworkCacheIndex::save(const QString &path) const
+{
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream << quint32(0x4f4e4349) << quint32(5);
+
+	stream.setVersion(QDataStream::Qt_5_2);
+	stream << m_inflation << quint32(m_entries.count());
+
+	QHash<QUrl, Entry>::const_iterator iterator;
+
+	for (iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator)
+	{
+		const Entry &entry = iterator.value();
+
+		stream << entry.metaData << entry.path << entry.type << entry.lastModified << entry.expirationDate << entry.timeStored << entry.lastAccess << entry.blob << entry.size << entry.blobSize << entry.dataSize << entry.hits << entry.isCompressed;
+	}
+
+	return file.commit();
+}
+
+void NetworkCacheIndex::addCandidate(const Entry &entry)
+{
+	m_priorities.insert(entry.priority, entry.url);
+
+	if (entry.expirationDate.isValid())
+	{
+		m_expirations.insert(entry.expirationDate, entry.url);
+	}
+}
+
+void NetworkCacheIndex::removeCandidate(const Entry &entry)
+{
+	m_priorities.remove(entry.priority, entry.url);
+
+	if (entry.expirationDate.isValid())
+	{
+		m_expirations.remove(entry.expirationDate, entry.url);
+	}
+}
+
+qreal NetworkCacheIndex::getPriority(const Entry &entry) const
+{
+	return (m_inflation + (entry.hits / ((qreal) (entry.size + entry.blobSize + 1023) / 1024)));
+}
+
+bool NetworkCacheIndex::isShared(const Entry &entry) const
+{
+	return (!entry.blob.isEmpty() && m_blobs.value(entry.blob).references > 1);
+}
+
+NetworkCacheIndex::Entry NetworkCacheIndex::createEntry(const QNetworkCacheMetaData &metaData, const QString &path, qint64 size, const QDateTime &timeStored)
+{
+	Entry entry;
+	entry.metaData = metaData;
+	entry.url = metaData.url();
+	entry.path = path;
+	entry.lastModified = metaData.lastModified();
+	entry.expirationDate = metaData.expirationDate();
+	entry.timeStored = timeStored;
+	entry.blob = getBlob(metaData);
+	entry.size = size;
+	entry.isCompressed = isCompressed(metaData);
+
+	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.toLower() == "content-type")
+		{
+			entry.type = QString::fromLatin1(headers.at(i).second);
+
+			break;
+		}
+	}
+
+	return entry;
+}
+
+void NetworkCacheIndex::setCompressed(QNetworkCacheMetaData &metaData, bool isCompressed)
+{
+	QNetworkCacheMetaData::AttributesMap attributes = metaData.attributes();
+
+	if (isCompressed)
+	{
+		attributes[(QNetworkRequest::Attribute) CompressionAttribute] = true;
+	}
+	else
+	{
+		attributes.remove((QNetworkRequest::Attribute) CompressionAttribute);
+	}
+
+	metaData.setAttributes(attributes);
+}
+
+void NetworkCacheIndex::setBlob(QNetworkCacheMetaData &metaData, const QByteArray &blob)
+{
+	QNetworkCacheMetaData::AttributesMap attributes = metaData.attributes();
+
+	if (blob.isEmpty())
+	{
+		attributes.remove((QNetworkRequest::Attribute) BlobAttribute);
+	}
+	else
+	{
+		attributes[(QNetworkRequest::Attribute) BlobAttribute] = blob;
+	}
+
+	metaData.setAttributes(attributes);
+}
+
+QString NetworkCacheIndex::getBlobPath(const QByteArray &blob)
+{
+	return QLatin1String("blobs/") + QString::fromLatin1(blob.left(2)) + QLatin1Char('/') + QString::fromLatin1(blob);
+}
+
+QByteArray NetworkCacheIndex::getBlob(const QNetworkCacheMetaData &metaData)
+{
+	return metaData.attributes().value((QNetworkRequest::Attribute) BlobAttribute).toByteArray();
+}
+
+bool NetworkCacheIndex::isCompressed(const QNetworkCacheMetaData &metaData)
+{
+	return metaData.attributes().value((QNetworkRequest::Attribute) CompressionAttribute).toBool();
+}
+
+bool NetworkCacheIndex::isCompressible(const QNetworkCacheMetaData &metaData, qint64 size)
+{
+	if (size < 256)
+	{
+		return false;
+	}
+
+	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
+	QByteArray type;
+	bool hasLength = false;
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		const QByteArray header = headers.at(i).first.toLower();
+
+		if (header == "content-type")
+		{
+			type = headers.at(i).second.toLower();
+
+			if (type.contains(';'))
+			{
+				type.truncate(type.indexOf(';'));
+			}
+
+			type = type.trimmed();
+		}
+		else if (header == "content-length")
+		{
+			hasLength = (headers.at(i).second.toLongLong() <= (3 * 1024 * 1024));
+		}
+	}
+
+	const bool isText = type.startsWith("text/");
+	const bool isScript = (type.startsWith("application/") && (type.endsWith("javascript") || type.endsWith("ecmascript")));
+
+	// QNetworkDiskCache already compresses these itself when they are stored inline
+	if (!isShareable(size) && hasLength && (isText || isScript))
+	{
+		return false;
+	}
+
+	return (isText || isScript || type == "application/json" || type == "application/xml" || type.endsWith("+json") || type.endsWith("+xml"));
+}
+
+bool NetworkCacheIndex::isShareable(qint64 size)
+{
+	return (size >= 4096);
+}
+
+}
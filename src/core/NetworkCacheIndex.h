@@ -0,0 +1,126 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKCACHEINDEX_H
+#define OTTER_NETWORKCACHEINDEX_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkCacheMetaData>
+#include <QtNetwork/QNetworkRequest>
+
+namespace Otter
+{
+
+class NetworkCacheIndex
+{
+public:
+	enum AttributeIdentifier
+	{
+		CompressionAttribute = (QNetworkRequest::User + 1),
+		BlobAttribute = (QNetworkRequest::User + 2)
+	};
+
+	struct Entry
+	{
+		QNetworkCacheMetaData metaData;
+		QUrl url;
+		QString path;
+		QString type;
+		QDateTime lastModified;
+		QDateTime expirationDate;
+		QDateTime timeStored;
+		QDateTime lastAccess;
+		QByteArray blob;
+		qint64 size;
+		qint64 blobSize;
+		qint64 dataSize;
+		qreal priority;
+		int hits;
+		bool isCompressed;
+
+		Entry() : size(0), blobSize(0), dataSize(-1), priority(0), hits(0), isCompressed(false) {}
+	};
+
+	struct HostInformation
+	{
+		qint64 size;
+		qint64 timeStored;
+		int entries;
+
+		HostInformation() : size(0), timeStored(0), entries(0) {}
+	};
+
+	NetworkCacheIndex();
+
+	void addEntry(const Entry &entry);
+	void removeEntry(const QUrl &url);
+	void evictEntry(const QUrl &url);
+	void markAccessed(const QUrl &url);
+	void clear();
+	Entry getEntry(const QUrl &url) const;
+	QList<Entry> getEntries() const;
+	QList<QUrl> getUrls() const;
+	QList<QUrl> getEvictionCandidates(int amount) const;
+	QHash<QString, HostInformation> getHosts() const;
+	qint64 getTotalSize() const;
+	qint64 getLogicalSize() const;
+	int getEntriesAmount() const;
+	bool hasEntry(const QUrl &url) const;
+	bool load(const QString &path);
+	bool save(const QString &path) const;
+	static Entry createEntry(const QNetworkCacheMetaData &metaData, const QString &path, qint64 size, const QDateTime &timeStored);
+	static void setCompressed(QNetworkCacheMetaData &metaData, bool isCompressed);
+	static void setBlob(QNetworkCacheMetaData &metaData, const QByteArray &blob);
+	static QString getBlobPath(const QByteArray &blob);
+	static QByteArray getBlob(const QNetworkCacheMetaData &metaData);
+	static bool isCompressed(const QNetworkCacheMetaData &metaData);
+	static bool isCompressible(const QNetworkCacheMetaData &metaData, qint64 size);
+	static bool isShareable(qint64 size);
+
+protected:
+	struct BlobInformation
+	{
+		qint64 size;
+		int references;
+
+		BlobInformation() : size(0), references(0) {}
+	};
+
+	void addCandidate(const Entry &entry);
+	void removeCandidate(const Entry &entry);
+	qreal getPriority(const Entry &entry) const;
+	bool isShared(const Entry &entry) const;
+
+private:
+	QHash<QUrl, Entry> m_entries;
+	QHash<QByteArray, BlobInformation> m_blobs;
+	QHash<QString, HostInformation> m_hosts;
+	QMultiMap<qreal, QUrl> m_priorities;
+	QMultiMap<QDateTime, QUrl> m_expirations;
+	qint64 m_totalSize;
+	qint64 m_logicalSize;
+	qreal m_inflation;
+};
+
+}
+
+#endif
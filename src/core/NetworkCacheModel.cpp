@@ -0,0 +1,650 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkCacheModel.h"
+#include "FaviconsCache.h"
+#include "NetworkCache.h"
+#include "NetworkManagerFactory.h"
+#include "Utils.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+NetworkCacheModel::Comparator::Comparator(int column, Qt::SortOrder order) : m_column(column),
+	m_order(order)
+{
+}
+
+bool NetworkCacheModel::Comparator::operator()(const NetworkCacheIndex::Entry &first, const NetworkCacheIndex::Entry &second) const
+{
+	const NetworkCacheIndex::Entry &left = ((m_order == Qt::AscendingOrder) ? first : second);
+	const NetworkCacheIndex::Entry &right = ((m_order == Qt::AscendingOrder) ? second : first);
+
+	switch (m_column)
+	{
+		case 1:
+			return (left.type < right.type);
+		case 2:
+			return (getEntrySize(left) < getEntrySize(right));
+		case 3:
+			return (left.lastModified < right.lastModified);
+		case 4:
+			return (left.expirationDate < right.expirationDate);
+		default:
+			break;
+	}
+
+	return (left.url.path() < right.url.path());
+}
+
+bool NetworkCacheModel::Comparator::operator()(const Domain *first, const Domain *second) const
+{
+	const Domain *left = ((m_order == Qt::AscendingOrder) ? first : second);
+	const Domain *right = ((m_order == Qt::AscendingOrder) ? second : first);
+
+	if (m_column == 2)
+	{
+		return (left->size < right->size);
+	}
+
+	return (left->name < right->name);
+}
+
+NetworkCacheModel::NetworkCacheModel(QObject *parent) : QAbstractItemModel(parent),
+	m_loadingWatcher(new QFutureWatcher<QHash<QString, QVector<NetworkCacheIndex::Entry> > >(this)),
+	m_sortOrder(Qt::AscendingOrder),
+	m_sortColumn(0)
+{
+	NetworkCache *cache = NetworkManagerFactory::getCache();
+
+	connect(m_loadingWatcher, SIGNAL(finished()), this, SLOT(loadingFinished()));
+
+	m_loadingWatcher->setFuture(QtConcurrent::run(&NetworkCacheModel::groupEntries, cache->getIndex(), m_sortColumn, m_sortOrder));
+
+	connect(cache, SIGNAL(cleared()), this, SLOT(clearEntries()));
+	connect(cache, SIGNAL(entryAdded(QUrl)), this, SLOT(addEntry(QUrl)));
+	connect(cache, SIGNAL(entryRemoved(QUrl)), this, SLOT(removeEntry(QUrl)));
+	connect(FaviconsCache::getInstance(), SIGNAL(iconsChanged(QStringList)), this, SLOT(updateIcons()));
+}
+
+NetworkCacheModel::~NetworkCacheModel()
+{
+	qDeleteAll(m_domains);
+}
+
+void NetworkCacheModel::loadingFinished()
+{
+	const QHash<QString, QVector<NetworkCacheIndex::Entry> > domains = m_loadingWatcher->result();
+	const Comparator comparator(m_sortColumn, m_sortOrder);
+	const bool needsSorting = (m_sortColumn != 0 || m_sortOrder != Qt::AscendingOrder);
+
+	m_loadingWatcher->deleteLater();
+	m_loadingWatcher = NULL;
+
+	beginResetModel();
+
+	QHash<QString, QVector<NetworkCacheIndex::Entry> >::const_iterator iterator;
+
+	for (iterator = domains.constBegin(); iterator != domains.constEnd(); ++iterator)
+	{
+		Domain *domain = new Domain();
+		domain->name = iterator.key();
+		domain->entries = iterator.value();
+
+		if (needsSorting)
+		{
+			std::sort(domain->entries.begin(), domain->entries.end(), comparator);
+		}
+
+		for (int i = 0; i < domain->entries.count(); ++i)
+		{
+			domain->size += getEntrySize(domain->entries.at(i));
+
+			if (!m_filter.isEmpty() && isMatching(domain->entries.at(i), m_filter))
+			{
+				domain->visibleEntries.append(domain->entries.at(i));
+			}
+		}
+
+		if (m_filter.isEmpty())
+		{
+			domain->visibleEntries = domain->entries;
+		}
+
+		m_domains.append(domain);
+		m_domainsByName[domain->name] = domain;
+
+		if (!domain->visibleEntries.isEmpty())
+		{
+			m_visibleDomains.append(domain);
+		}
+	}
+
+	std::sort(m_domains.begin(), m_domains.end(), comparator);
+	std::sort(m_visibleDomains.begin(), m_visibleDomains.end(), comparator);
+
+	endResetModel();
+
+	for (int i = 0; i < m_pendingChanges.count(); ++i)
+	{
+		if (m_pendingChanges.at(i).second)
+		{
+			addEntry(m_pendingChanges.at(i).first);
+		}
+		else
+		{
+			removeEntry(m_pendingChanges.at(i).first);
+		}
+	}
+
+	m_pendingChanges.clear();
+
+	emit modelLoaded();
+}
+
+void NetworkCacheModel::addEntry(const QUrl &url)
+{
+	if (isLoading())
+	{
+		m_pendingChanges.append(qMakePair(url, true));
+
+		return;
+	}
+
+	const NetworkCacheIndex::Entry entry = NetworkManagerFactory::getCache()->getEntry(url);
+
+	removeEntry(url);
+
+	if (entry.url.isValid())
+	{
+		insertEntry(entry);
+	}
+}
+
+void NetworkCacheModel::insertEntry(const NetworkCacheIndex::Entry &entry)
+{
+	const Comparator comparator(m_sortColumn, m_sortOrder);
+	const QString host = entry.url.host();
+	Domain *domain = m_domainsByName.value(host);
+
+	if (!domain)
+	{
+		domain = new Domain();
+		domain->name = host;
+
+		m_domains.insert(std::upper_bound(m_domains.begin(), m_domains.end(), domain, comparator), domain);
+		m_domainsByName[host] = domain;
+	}
+
+	domain->entries.insert(std::upper_bound(domain->entries.begin(), domain->entries.end(), entry, comparator), entry);
+	domain->size += getEntrySize(entry);
+
+	int domainRow = m_visibleDomains.indexOf(domain);
+
+	if (isMatching(entry, m_filter))
+	{
+		if (domainRow < 0)
+		{
+			domainRow = (std::upper_bound(m_visibleDomains.begin(), m_visibleDomains.end(), domain, comparator) - m_visibleDomains.begin());
+
+			beginInsertRows(QModelIndex(), domainRow, domainRow);
+
+			domain->visibleEntries.append(entry);
+
+			m_visibleDomains.insert(domainRow, domain);
+
+			endInsertRows();
+
+			return;
+		}
+
+		const int row = (std::upper_bound(domain->visibleEntries.begin(), domain->visibleEntries.end(), entry, comparator) - domain->visibleEntries.begin());
+
+		beginInsertRows(index(domainRow, 0), row, row);
+
+		domain->visibleEntries.insert(row, entry);
+
+		endInsertRows();
+	}
+
+	if (domainRow >= 0)
+	{
+		emit dataChanged(index(domainRow, 0), index(domainRow, 2));
+	}
+}
+
+void NetworkCacheModel::removeEntry(const QUrl &url)
+{
+	if (isLoading())
+	{
+		m_pendingChanges.append(qMakePair(url, false));
+
+		return;
+	}
+
+	Domain *domain = m_domainsByName.value(url.host());
+
+	if (!domain)
+	{
+		return;
+	}
+
+	for (int i = 0; i < domain->entries.count(); ++i)
+	{
+		if (domain->entries.at(i).url == url)
+		{
+			domain->size -= getEntrySize(domain->entries.at(i));
+			domain->entries.remove(i);
+
+			break;
+		}
+	}
+
+	int domainRow = m_visibleDomains.indexOf(domain);
+
+	for (int i = 0; (domainRow >= 0 && i < domain->visibleEntries.count()); ++i)
+	{
+		if (domain->visibleEntries.at(i).url != url)
+		{
+			continue;
+		}
+
+		if (domain->visibleEntries.count() == 1)
+		{
+			beginRemoveRows(QModelIndex(), domainRow, domainRow);
+
+			domain->visibleEntries.clear();
+
+			m_visibleDomains.removeAt(domainRow);
+
+			endRemoveRows();
+
+			domainRow = -1;
+		}
+		else
+		{
+			beginRemoveRows(index(domainRow, 0), i, i);
+
+			domain->visibleEntries.remove(i);
+
+			endRemoveRows();
+		}
+
+		break;
+	}
+
+	if (domain->entries.isEmpty())
+	{
+		m_domains.removeAll(domain);
+		m_domainsByName.remove(domain->name);
+
+		delete domain;
+	}
+	else if (domainRow >= 0)
+	{
+		emit dataChanged(index(domainRow, 0), index(domainRow, 2));
+	}
+}
+
+void NetworkCacheModel::clearEntries()
+{
+	if (isLoading())
+	{
+		m_loadingWatcher->disconnect(this);
+		m_loadingWatcher->deleteLater();
+		m_loadingWatcher = NULL;
+
+		m_pendingChanges.clear();
+
+		emit modelLoaded();
+
+		return;
+	}
+
+	beginResetModel();
+
+	clearDomains();
+
+	endResetModel();
+}
+
+void NetworkCacheModel::clearDomains()
+{
+	qDeleteAll(m_domains);
+
+	m_domains.clear();
+	m_visibleDomains.clear();
+	m_domainsByName.clear();
+}
+
+void NetworkCacheModel::updateIcons()
+{
+	if (!m_visibleDomains.isEmpty())
+	{
+		emit dataChanged(index(0, 0), index((m_visibleDomains.count() - 1), 0));
+	}
+}
+
+void NetworkCacheModel::sort(int column, Qt::SortOrder order)
+{
+	if (column == m_sortColumn && order == m_sortOrder)
+	{
+		return;
+	}
+
+	m_sortColumn = column;
+	m_sortOrder = order;
+
+	if (isLoading())
+	{
+		return;
+	}
+
+	const Comparator comparator(m_sortColumn, m_sortOrder);
+
+	beginResetModel();
+
+	std::sort(m_domains.begin(), m_domains.end(), comparator);
+	std::sort(m_visibleDomains.begin(), m_visibleDomains.end(), comparator);
+
+	for (int i = 0; i < m_domains.count(); ++i)
+	{
+		std::sort(m_domains[i]->entries.begin(), m_domains[i]->entries.end(), comparator);
+		std::sort(m_domains[i]->visibleEntries.begin(), m_domains[i]->visibleEntries.end(), comparator);
+	}
+
+	endResetModel();
+}
+
+void NetworkCacheModel::setFilter(const QString &filter)
+{
+	if (filter == m_filter)
+	{
+		return;
+	}
+
+	const bool isNarrowing = (!m_filter.isEmpty() && filter.contains(m_filter, Qt::CaseInsensitive));
+
+	m_filter = filter;
+
+	if (isLoading())
+	{
+		return;
+	}
+
+	beginResetModel();
+
+	m_visibleDomains.clear();
+
+	for (int i = 0; i < m_domains.count(); ++i)
+	{
+		Domain *domain = m_domains.at(i);
+
+		if (filter.isEmpty())
+		{
+			domain->visibleEntries = domain->entries;
+		}
+		else
+		{
+			const QVector<NetworkCacheIndex::Entry> entries = (isNarrowing ? domain->visibleEntries : domain->entries);
+			QVector<NetworkCacheIndex::Entry> visibleEntries;
+
+			for (int j = 0; j < entries.count(); ++j)
+			{
+				if (isMatching(entries.at(j), filter))
+				{
+					visibleEntries.append(entries.at(j));
+				}
+			}
+
+			domain->visibleEntries = visibleEntries;
+		}
+
+		if (!domain->visibleEntries.isEmpty())
+		{
+			m_visibleDomains.append(domain);
+		}
+	}
+
+	endResetModel();
+}
+
+QModelIndex NetworkCacheModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (!hasIndex(row, column, parent))
+	{
+		return QModelIndex();
+	}
+
+	if (!parent.isValid())
+	{
+		return createIndex(row, column);
+	}
+
+	return createIndex(row, column, m_visibleDomains.at(parent.row()));
+}
+
+QModelIndex NetworkCacheModel::parent(const QModelIndex &child) const
+{
+	Domain *domain = (child.isValid() ? static_cast<Domain*>(child.internalPointer()) : NULL);
+
+	if (!domain)
+	{
+		return QModelIndex();
+	}
+
+	return createIndex(m_visibleDomains.indexOf(domain), 0);
+}
+
+QVariant NetworkCacheModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return QVariant();
+	}
+
+	const Domain *parentDomain = static_cast<Domain*>(index.internalPointer());
+
+	if (!parentDomain)
+	{
+		if (index.row() >= m_visibleDomains.count())
+		{
+			return QVariant();
+		}
+
+		const Domain *domain = m_visibleDomains.at(index.row());
+
+		if (index.column() == 0)
+		{
+			switch (role)
+			{
+				case Qt::DisplayRole:
+					return QStringLiteral("%1 (%2)").arg(domain->name).arg(domain->entries.count());
+				case Qt::DecorationRole:
+					return FaviconsCache::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain->name)));
+				case Qt::ToolTipRole:
+					return domain->name;
+				default:
+					break;
+			}
+		}
+		else if (index.column() == 2 && role == Qt::DisplayRole)
+		{
+			return Utils::formatUnit(domain->size);
+		}
+
+		return QVariant();
+	}
+
+	if (index.row() >= parentDomain->visibleEntries.count())
+	{
+		return QVariant();
+	}
+
+	const NetworkCacheIndex::Entry &entry = parentDomain->visibleEntries.at(index.row());
+
+	if (role == Qt::UserRole && index.column() == 0)
+	{
+		return entry.url;
+	}
+
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+
+	switch (index.column())
+	{
+		case 0:
+			return entry.url.path();
+		case 1:
+			return entry.type.section(QLatin1Char(';'), 0, 0).trimmed();
+		case 2:
+			return Utils::formatUnit(getEntrySize(entry));
+		case 3:
+			return entry.lastModified.toString();
+		case 4:
+			return entry.expirationDate.toString();
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+
+QVariant NetworkCacheModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+			case 0:
+				return tr("Address");
+			case 1:
+				return tr("Type");
+			case 2:
+				return tr("Size");
+			case 3:
+				return tr("Last Modified");
+			case 4:
+				return tr("Expires");
+			default:
+				break;
+		}
+	}
+
+	return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+QHash<QString, QVector<NetworkCacheIndex::Entry> > NetworkCacheModel::groupEntries(const NetworkCacheIndex &index, int column, Qt::SortOrder order)
+{
+	const QList<NetworkCacheIndex::Entry> entries = index.getEntries();
+	const Comparator comparator(column, order);
+	QHash<QString, QVector<NetworkCacheIndex::Entry> > domains;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		domains[entries.at(i).url.host()].append(entries.at(i));
+	}
+
+	QHash<QString, QVector<NetworkCacheIndex::Entry> >::iterator iterator;
+
+	for (iterator = domains.begin(); iterator != domains.end(); ++iterator)
+	{
+		std::sort(iterator.value().begin(), iterator.value().end(), comparator);
+	}
+
+	return domains;
+}
+
+QUrl NetworkCacheModel::getUrl(const QModelIndex &index) const
+{
+	return ((index.isValid() && index.internalPointer()) ? data(index.sibling(index.row(), 0), Qt::UserRole).toUrl() : QUrl());
+}
+
+QString NetworkCacheModel::getDomain(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return QString();
+	}
+
+	const Domain *domain = (index.internalPointer() ? static_cast<Domain*>(index.internalPointer()) : m_visibleDomains.value(index.row()));
+
+	return (domain ? domain->name : QString());
+}
+
+QList<QUrl> NetworkCacheModel::getDomainUrls(const QString &domain) const
+{
+	QList<QUrl> urls;
+	const Domain *data = m_domainsByName.value(domain);
+
+	if (data)
+	{
+		for (int i = 0; i < data->entries.count(); ++i)
+		{
+			urls.append(data->entries.at(i).url);
+		}
+	}
+
+	return urls;
+}
+
+qint64 NetworkCacheModel::getEntrySize(const NetworkCacheIndex::Entry &entry)
+{
+	return (entry.size + entry.blobSize);
+}
+
+int NetworkCacheModel::rowCount(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return m_visibleDomains.count();
+	}
+
+	if (parent.column() == 0 && !parent.internalPointer() && parent.row() < m_visibleDomains.count())
+	{
+		return m_visibleDomains.at(parent.row())->visibleEntries.count();
+	}
+
+	return 0;
+}
+
+int NetworkCacheModel::columnCount(const QModelIndex &parent) const
+{
+	Q_UNUSED(parent)
+
+	return 5;
+}
+
+bool NetworkCacheModel::isMatching(const NetworkCacheIndex::Entry &entry, const QString &filter)
+{
+	return (filter.isEmpty() || entry.url.toString().contains(filter, Qt::CaseInsensitive) || entry.type.contains(filter, Qt::CaseInsensitive));
+}
+
+bool NetworkCacheModel::isLoading() const
+{
+	return (m_loadingWatcher != NULL);
+}
+
+}
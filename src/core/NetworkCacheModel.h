@@ -0,0 +1,106 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKCACHEMODEL_H
+#define OTTER_NETWORKCACHEMODEL_H
+
+#include "NetworkCacheIndex.h"
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class NetworkCacheModel : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkCacheModel(QObject *parent = NULL);
+	~NetworkCacheModel();
+
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+	void setFilter(const QString &filter);
+	QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+	QModelIndex parent(const QModelIndex &child) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	QUrl getUrl(const QModelIndex &index) const;
+	QString getDomain(const QModelIndex &index) const;
+	QList<QUrl> getDomainUrls(const QString &domain) const;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	bool isLoading() const;
+
+protected:
+	struct Domain
+	{
+		QString name;
+		QVector<NetworkCacheIndex::Entry> entries;
+		QVector<NetworkCacheIndex::Entry> visibleEntries;
+		qint64 size;
+
+		Domain() : size(0) {}
+	};
+
+	class Comparator
+	{
+	public:
+		explicit Comparator(int column, Qt::SortOrder order);
+
+		bool operator()(const NetworkCacheIndex::Entry &first, const NetworkCacheIndex::Entry &second) const;
+		bool operator()(const Domain *first, const Domain *second) const;
+
+	private:
+		int m_column;
+		Qt::SortOrder m_order;
+	};
+
+	void insertEntry(const NetworkCacheIndex::Entry &entry);
+	void clearDomains();
+	static QHash<QString, QVector<NetworkCacheIndex::Entry> > groupEntries(const NetworkCacheIndex &index, int column, Qt::SortOrder order);
+	static qint64 getEntrySize(const NetworkCacheIndex::Entry &entry);
+	static bool isMatching(const NetworkCacheIndex::Entry &entry, const QString &filter);
+
+protected slots:
+	void loadingFinished();
+	void addEntry(const QUrl &url);
+	void removeEntry(const QUrl &url);
+	void clearEntries();
+	void updateIcons();
+
+private:
+	QFutureWatcher<QHash<QString, QVector<NetworkCacheIndex::Entry> > > *m_loadingWatcher;
+	QList<Domain*> m_domains;
+	QList<Domain*> m_visibleDomains;
+	QHash<QString, Domain*> m_domainsByName;
+	QList<QPair<QUrl, bool> > m_pendingChanges;
+	QString m_filter;
+	Qt::SortOrder m_sortOrder;
+	int m_sortColumn;
+
+signals:
+	void modelLoaded();
+};
+
+}
+
+#endif
@@ -0,0 +1,316 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkCacheWorker.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#include <limits>
+
+namespace Otter
+{
+
+NetworkCacheWorker::NetworkCacheWorker(const QString &path, QObject *parent) : QNetworkDiskCache(parent)
+{
+	setCacheDirectory(path);
+	setMaximumCacheSize(std::numeric_limits<qint64>::max());
+}
+
+void NetworkCacheWorker::writeEntry(const QNetworkCacheMetaData &metaData, const QByteArray &data)
+{
+	const QByteArray payload = (NetworkCacheIndex::isCompressed(metaData) ? qCompress(data) : data);
+	QNetworkCacheMetaData storedMetaData(metaData);
+	QByteArray blob;
+
+	if (NetworkCacheIndex::isShareable(data.size()))
+	{
+		blob = QCryptographicHash::hash(payload, QCryptographicHash::Sha1).toHex();
+
+		const QString blobPath = cacheDirectory() + NetworkCacheIndex::getBlobPath(blob);
+
+		if (!QFile::exists(blobPath))
+		{
+			QDir().mkpath(QFileInfo(blobPath).absolutePath());
+
+			QSaveFile file(blobPath);
+
+			if (!file.open(QIODevice::WriteOnly) || file.write(payload) != payload.size() || !file.commit())
+			{
+				blob.clear();
+			}
+		}
+	}
+
+	NetworkCacheIndex::setBlob(storedMetaData, blob);
+
+	QIODevice *device = prepare(storedMetaData);
+
+	if (!device)
+	{
+		if (!blob.isEmpty() && !m_references.contains(blob))
+		{
+			QFile::remove(cacheDirectory() + NetworkCacheIndex::getBlobPath(blob));
+		}
+
+		return;
+	}
+
+	if (blob.isEmpty())
+	{
+		device->write(payload);
+	}
+
+	insert(device);
+	updateReference(metaData.url(), blob);
+
+	QByteArray header;
+	QDataStream stream(&header, QIODevice::WriteOnly);
+	stream << storedMetaData;
+
+	NetworkCacheIndex::Entry entry = NetworkCacheIndex::createEntry(storedMetaData, QString(), (header.size() + (blob.isEmpty() ? payload.size() : 0)), QDateTime::currentDateTimeUtc());
+	entry.blobSize = (blob.isEmpty() ? 0 : payload.size());
+	entry.dataSize = data.size();
+
+	emit entryWritten(entry);
+}
+
+void NetworkCacheWorker::updateEntry(const QNetworkCacheMetaData &metaData)
+{
+	const QNetworkCacheMetaData storedMetaData = QNetworkDiskCache::metaData(metaData.url());
+
+	if (!storedMetaData.isValid())
+	{
+		return;
+	}
+
+	QNetworkCacheMetaData updatedMetaData(metaData);
+
+	NetworkCacheIndex::setCompressed(updatedMetaData, NetworkCacheIndex::isCompressed(storedMetaData));
+	NetworkCacheIndex::setBlob(updatedMetaData, NetworkCacheIndex::getBlob(storedMetaData));
+
+	updateMetaData(updatedMetaData);
+}
+
+void NetworkCacheWorker::readEntry(int identifier, const NetworkCacheIndex::Entry &entry)
+{
+	QIODevice *device = NULL;
+
+	if (entry.blob.isEmpty())
+	{
+		device = data(entry.url);
+	}
+	else
+	{
+		device = new QFile(cacheDirectory() + NetworkCacheIndex::getBlobPath(entry.blob));
+
+		if (!device->open(QIODevice::ReadOnly))
+		{
+			delete device;
+
+			device = NULL;
+		}
+	}
+
+	if (!device)
+	{
+		emit entryRead(identifier, entry.url, QByteArray(), false);
+
+		return;
+	}
+
+	if (entry.isCompressed)
+	{
+		const QByteArray payload = qUncompress(device->readAll());
+
+		delete device;
+
+		emit entryRead(identifier, entry.url, payload, (entry.dataSize < 0 || payload.size() == entry.dataSize));
+
+		return;
+	}
+
+	QByteArray payload = device->read(1048576);
+	qint64 size = payload.size();
+
+	while (!device->atEnd())
+	{
+		emit entryDataRead(identifier, payload);
+
+		payload = device->read(1048576);
+
+		if (payload.isEmpty())
+		{
+			break;
+		}
+
+		size += payload.size();
+	}
+
+	delete device;
+
+	emit entryRead(identifier, entry.url, payload, (entry.dataSize < 0 || size == entry.dataSize));
+}
+
+void NetworkCacheWorker::removeEntries(const QList<QUrl> &urls)
+{
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		remove(urls.at(i));
+		updateReference(urls.at(i), QByteArray());
+	}
+}
+
+void NetworkCacheWorker::clearEntries()
+{
+	clear();
+
+	QDir(cacheDirectory() + QLatin1String("blobs/")).removeRecursively();
+
+	m_blobs.clear();
+	m_references.clear();
+}
+
+void NetworkCacheWorker::scanEntries()
+{
+	m_blobs.clear();
+	m_references.clear();
+
+	const QDir cacheMainDirectory(cacheDirectory());
+	QDirIterator iterator(cacheDirectory(), QStringList(QLatin1String("*.d")), QDir::Files, QDirIterator::Subdirectories);
+	QList<NetworkCacheIndex::Entry> entries;
+
+	while (iterator.hasNext())
+	{
+		iterator.next();
+
+		const QNetworkCacheMetaData metaData = fileMetaData(iterator.filePath());
+
+		if (!metaData.isValid() || !metaData.url().isValid())
+		{
+			continue;
+		}
+
+		const QString path = cacheMainDirectory.relativeFilePath(iterator.filePath());
+		NetworkCacheIndex::Entry entry = NetworkCacheIndex::createEntry(metaData, path, iterator.fileInfo().size(), iterator.fileInfo().lastModified().toUTC());
+
+		if (!entry.blob.isEmpty())
+		{
+			const QFileInfo blobInfo(cacheDirectory() + NetworkCacheIndex::getBlobPath(entry.blob));
+
+			if (!blobInfo.exists())
+			{
+				QFile::remove(iterator.filePath());
+
+				continue;
+			}
+
+			entry.blobSize = blobInfo.size();
+
+			updateReference(entry.url, entry.blob);
+		}
+
+		entries.append(entry);
+	}
+
+	removeUnusedBlobs();
+
+	emit entriesScanned(entries);
+}
+
+void NetworkCacheWorker::setEntries(const QList<NetworkCacheIndex::Entry> &entries)
+{
+	m_blobs.clear();
+	m_references.clear();
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		updateReference(entries.at(i).url, entries.at(i).blob);
+	}
+}
+
+void NetworkCacheWorker::saveIndex(const NetworkCacheIndex &index)
+{
+	index.save(cacheDirectory() + QLatin1String("index.dat"));
+}
+
+void NetworkCacheWorker::synchronize()
+{
+}
+
+qint64 NetworkCacheWorker::expire()
+{
+	if (maximumCacheSize() <= 0)
+	{
+		return QNetworkDiskCache::expire();
+	}
+
+	return 0;
+}
+
+void NetworkCacheWorker::updateReference(const QUrl &url, const QByteArray &blob)
+{
+	const QByteArray previousBlob = m_blobs.value(url);
+
+	if (blob.isEmpty())
+	{
+		m_blobs.remove(url);
+	}
+	else
+	{
+		m_blobs[url] = blob;
+
+		++m_references[blob];
+	}
+
+	if (previousBlob.isEmpty())
+	{
+		return;
+	}
+
+	--m_references[previousBlob];
+
+	if (m_references.value(previousBlob) <= 0)
+	{
+		m_references.remove(previousBlob);
+
+		QFile::remove(cacheDirectory() + NetworkCacheIndex::getBlobPath(previousBlob));
+	}
+}
+
+void NetworkCacheWorker::removeUnusedBlobs()
+{
+	QDirIterator iterator(cacheDirectory() + QLatin1String("blobs/"), QDir::Files, QDirIterator::Subdirectories);
+
+	while (iterator.hasNext())
+	{
+		iterator.next();
+
+		if (!m_references.contains(iterator.fileName().toLatin1()))
+		{
+			QFile::remove(iterator.filePath());
+		}
+	}
+}
+
+}
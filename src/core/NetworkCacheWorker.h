@@ -0,0 +1,66 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKCACHEWORKER_H
+#define OTTER_NETWORKCACHEWORKER_H
+
+#include "NetworkCacheIndex.h"
+
+#include <QtNetwork/QNetworkDiskCache>
+
+namespace Otter
+{
+
+class NetworkCacheWorker : public QNetworkDiskCache
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkCacheWorker(const QString &path, QObject *parent = NULL);
+
+public slots:
+	void writeEntry(const QNetworkCacheMetaData &metaData, const QByteArray &data);
+	void updateEntry(const QNetworkCacheMetaData &metaData);
+	void readEntry(int identifier, const NetworkCacheIndex::Entry &entry);
+	void removeEntries(const QList<QUrl> &urls);
+	void clearEntries();
+	void scanEntries();
+	void setEntries(const QList<NetworkCacheIndex::Entry> &entries);
+	void saveIndex(const NetworkCacheIndex &index);
+	void synchronize();
+
+protected:
+	qint64 expire();
+	void updateReference(const QUrl &url, const QByteArray &blob);
+	void removeUnusedBlobs();
+
+private:
+	QHash<QUrl, QByteArray> m_blobs;
+	QHash<QByteArray, int> m_references;
+
+signals:
+	void entryWritten(const NetworkCacheIndex::Entry &entry);
+	void entryDataRead(int identifier, const QByteArray &data);
+	void entryRead(int identifier, const QUrl &url, const QByteArray &data, bool isSuccess);
+	void entriesScanned(const QList<NetworkCacheIndex::Entry> &entries);
+};
+
+}
+
+#endif
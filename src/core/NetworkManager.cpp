@@ -32,22 +32,25 @@
 #include <QtCore/QFileInfo>
 #include <QtWidgets/QMessageBox>
 #include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
 
 namespace Otter
 {
 
+QHash<QString, NetworkManager::HostStatistics> NetworkManager::m_hostStatistics;
+
 NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccessManager(parent),
-	m_cookieJar(NULL)
+	m_isTrackingReplies(!isPrivate)
 {
 	NetworkManagerFactory::initialize();
 
 	if (!isPrivate)
 	{
-		m_cookieJar = NetworkManagerFactory::getCookieJar();
+		CookieJar *cookieJar = NetworkManagerFactory::getCookieJar();
 
-		setCookieJar(m_cookieJar);
+		setCookieJar(cookieJar);
 
-		m_cookieJar->setParent(QCoreApplication::instance());
+		cookieJar->setParent(QCoreApplication::instance());
 
 		QNetworkDiskCache *cache = NetworkManagerFactory::getCache();
 
@@ -57,18 +60,105 @@ NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccess
 	}
 	else
 	{
-		m_cookieJar = new CookieJar(true, this);
-
-		setCookieJar(m_cookieJar);
+		setCookieJar(new CookieJar(true, this));
 	}
 
 	connect(this, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), this, SLOT(handleAuthenticationRequired(QNetworkReply*,QAuthenticator*)));
 	connect(this, SIGNAL(proxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)), this, SLOT(handleProxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)));
 	connect(this, SIGNAL(sslErrors(QNetworkReply*,QList<QSslError>)), this, SLOT(handleSslErrors(QNetworkReply*,QList<QSslError>)));
+	connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(updateHostStatistics(QNetworkReply*)));
+	connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(forwardRequestFinished(QNetworkReply*)));
+}
+
+void NetworkManager::trackReply(QNetworkReply *reply)
+{
+	if (!m_isTrackingReplies || !reply)
+	{
+		return;
+	}
+
+	m_trackedReplies[reply] = 0;
+
+	connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(updateReplyProgress(qint64,qint64)));
+}
+
+void NetworkManager::updateReplyProgress(qint64 bytesReceived, qint64 bytesTotal)
+{
+	Q_UNUSED(bytesTotal)
+
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (reply && m_trackedReplies.contains(reply))
+	{
+		m_trackedReplies[reply] = bytesReceived;
+	}
+}
+
+void NetworkManager::updateHostStatistics(QNetworkReply *reply)
+{
+	if (!m_trackedReplies.contains(reply))
+	{
+		return;
+	}
+
+	const qint64 bytesReceived = m_trackedReplies.take(reply);
+	HostStatistics &statistics = m_hostStatistics[reply->url().host()];
+
+	if (reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool())
+	{
+		statistics.cacheBytes += bytesReceived;
+
+		++statistics.cacheRequests;
+	}
+	else
+	{
+		statistics.networkBytes += bytesReceived;
+
+		++statistics.networkRequests;
+	}
+}
+
+void NetworkManager::forwardRequestFinished(QNetworkReply *reply)
+{
+	NetworkManager *client = m_clients.take(reply).data();
+
+	if (client)
+	{
+		client->notifyRequestFinished(reply);
+	}
+}
+
+void NetworkManager::notifyRequestFinished(QNetworkReply *reply)
+{
+	emit finished(reply);
+}
+
+void NetworkManager::removeClient(QObject *reply)
+{
+	m_clients.remove(static_cast<QNetworkReply*>(reply));
+}
+
+void NetworkManager::replayFinished()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (reply)
+	{
+		emit finished(reply);
+	}
 }
 
 void NetworkManager::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
 {
+	NetworkManager *client = m_clients.value(reply).data();
+
+	if (client)
+	{
+		client->handleAuthenticationRequired(reply, authenticator);
+
+		return;
+	}
+
 	AuthenticationDialog dialog(reply->url(), authenticator, SessionsManager::getActiveWindow());
 	dialog.exec();
 }
@@ -88,6 +178,15 @@ void NetworkManager::handleProxyAuthenticationRequired(const QNetworkProxy &prox
 
 void NetworkManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
 {
+	NetworkManager *client = m_clients.value(reply).data();
+
+	if (client)
+	{
+		client->handleSslErrors(reply, errors);
+
+		return;
+	}
+
 	if (errors.isEmpty())
 	{
 		reply->ignoreSslErrors(errors);
@@ -132,7 +231,7 @@ void NetworkManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError
 
 CookieJar* NetworkManager::getCookieJar()
 {
-	return m_cookieJar;
+	return qobject_cast<CookieJar*>(cookieJar());
 }
 
 QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
@@ -165,7 +264,43 @@ QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation op
 
 	mutableRequest.setRawHeader(QStringLiteral("Accept-Language").toLatin1(), NetworkManagerFactory::getAcceptLanguage().toLatin1());
 
-	return QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
+	QNetworkReply *reply = createSharedRequest(operation, mutableRequest, outgoingData);
+
+	trackReply(reply);
+
+	return reply;
+}
+
+QNetworkReply* NetworkManager::createSharedRequest(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+	if (NetworkManagerFactory::isReplayingArchive() && (request.url().scheme() == QLatin1String("http") || request.url().scheme() == QLatin1String("https")))
+	{
+		QNetworkReply *reply = NetworkManagerFactory::createReplayReply(operation, request, this);
+
+		connect(reply, SIGNAL(finished()), this, SLOT(replayFinished()));
+
+		return reply;
+	}
+
+	NetworkManager *manager = NetworkManagerFactory::getNetworkManager();
+
+	if (manager == this || manager->cookieJar() != cookieJar())
+	{
+		return QNetworkAccessManager::createRequest(operation, request, outgoingData);
+	}
+
+	QNetworkReply *reply = manager->QNetworkAccessManager::createRequest(operation, request, outgoingData);
+
+	manager->m_clients[reply] = this;
+
+	connect(reply, SIGNAL(destroyed(QObject*)), manager, SLOT(removeClient(QObject*)));
+
+	return reply;
+}
+
+QHash<QString, NetworkManager::HostStatistics> NetworkManager::getHostStatistics()
+{
+	return m_hostStatistics;
 }
 
 }
@@ -20,6 +20,8 @@
 #ifndef OTTER_NETWORKMANAGER_H
 #define OTTER_NETWORKMANAGER_H
 
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
 #include <QtNetwork/QNetworkAccessManager>
 
 namespace Otter
@@ -32,20 +34,43 @@ class NetworkManager : public QNetworkAccessManager
 	Q_OBJECT
 
 public:
+	struct HostStatistics
+	{
+		qint64 cacheBytes;
+		qint64 networkBytes;
+		int cacheRequests;
+		int networkRequests;
+
+		HostStatistics() : cacheBytes(0), networkBytes(0), cacheRequests(0), networkRequests(0) {}
+	};
+
 	explicit NetworkManager(bool isPrivate = false, QObject *parent = NULL);
 
 	CookieJar* getCookieJar();
+	static QHash<QString, HostStatistics> getHostStatistics();
 
 protected:
 	virtual QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	QNetworkReply* createSharedRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	void trackReply(QNetworkReply *reply);
 
 protected slots:
 	virtual void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
 	virtual void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
 	virtual void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+	void updateReplyProgress(qint64 bytesReceived, qint64 bytesTotal);
+	void updateHostStatistics(QNetworkReply *reply);
+	void forwardRequestFinished(QNetworkReply *reply);
+	void notifyRequestFinished(QNetworkReply *reply);
+	void removeClient(QObject *reply);
+	void replayFinished();
 
 private:
-	CookieJar *m_cookieJar;
+	QHash<QNetworkReply*, QPointer<NetworkManager> > m_clients;
+	QHash<QNetworkReply*, qint64> m_trackedReplies;
+	bool m_isTrackingReplies;
+
+	static QHash<QString, HostStatistics> m_hostStatistics;
 };
 
 }
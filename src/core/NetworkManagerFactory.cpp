@@ -25,6 +25,7 @@
 #include "NetworkCache.h"
 #include "NetworkManager.h"
 #include "NetworkProxyFactory.h"
+#include "ReplayNetworkReply.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "WebBackend.h"
@@ -38,6 +39,7 @@ namespace Otter
 {
 
 NetworkManagerFactory* NetworkManagerFactory::m_instance = NULL;
+NetworkManager* NetworkManagerFactory::m_networkManager = NULL;
 CookieJar* NetworkManagerFactory::m_cookieJar = NULL;
 NetworkCache* NetworkManagerFactory::m_cache = NULL;
 QString NetworkManagerFactory::m_acceptLanguage;
@@ -45,6 +47,9 @@ QStringList NetworkManagerFactory::m_userAgentsOrder;
 QMap<QString, UserAgentInformation> NetworkManagerFactory::m_userAgents;
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
 QList<QSslCipher> NetworkManagerFactory::m_defaultCiphers;
+QHash<QString, HttpArchive::Entry> NetworkManagerFactory::m_replayEntries;
+qint64 NetworkManagerFactory::m_replayBandwidth = 0;
+int NetworkManagerFactory::m_replayLatency = 0;
 bool NetworkManagerFactory::m_canSendReferrer = true;
 bool NetworkManagerFactory::m_isWorkingOffline = false;
 bool NetworkManagerFactory::m_isInitialized = false;
@@ -165,7 +170,7 @@ void NetworkManagerFactory::clearCookies(int period)
 {
 	if (!m_cookieJar)
 	{
-		m_cookieJar = new CookieJar(QCoreApplication::instance());
+		m_cookieJar = new CookieJar(false, QCoreApplication::instance());
 	}
 
 	m_cookieJar->clearCookies(period);
@@ -176,6 +181,27 @@ void NetworkManagerFactory::clearCache(int period)
 	m_cache->clearCache(period);
 }
 
+bool NetworkManagerFactory::loadReplayArchive(const QString &path, int latency, qint64 bandwidth)
+{
+	const QList<HttpArchive::Entry> entries = HttpArchive::load(path);
+
+	m_replayEntries.clear();
+	m_replayLatency = latency;
+	m_replayBandwidth = bandwidth;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QString key = getReplayKey(entries.at(i).method, entries.at(i).url);
+
+		if (!m_replayEntries.contains(key))
+		{
+			m_replayEntries[key] = entries.at(i);
+		}
+	}
+
+	return !m_replayEntries.isEmpty();
+}
+
 void NetworkManagerFactory::loadUserAgents()
 {
 	const QString path = (SessionsManager::getProfilePath() + QLatin1String("/userAgents.ini"));
@@ -202,6 +228,16 @@ NetworkManagerFactory* NetworkManagerFactory::getInstance()
 	return m_instance;
 }
 
+NetworkManager* NetworkManagerFactory::getNetworkManager()
+{
+	if (!m_networkManager)
+	{
+		m_networkManager = new NetworkManager(false, QCoreApplication::instance());
+	}
+
+	return m_networkManager;
+}
+
 CookieJar* NetworkManagerFactory::getCookieJar()
 {
 	if (!m_cookieJar)
@@ -222,6 +258,16 @@ NetworkCache* NetworkManagerFactory::getCache()
 	return m_cache;
 }
 
+QNetworkReply* NetworkManagerFactory::createReplayReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent)
+{
+	return new ReplayNetworkReply(parent, request, m_replayEntries.value(getReplayKey(HttpArchive::getMethod(operation, request), request.url())), m_replayLatency, m_replayBandwidth);
+}
+
+QString NetworkManagerFactory::getReplayKey(const QByteArray &method, const QUrl &url)
+{
+	return (QString::fromLatin1(method) + QLatin1Char(' ') + url.toString(QUrl::RemoveFragment | QUrl::FullyEncoded));
+}
+
 QString NetworkManagerFactory::getAcceptLanguage()
 {
 	return m_acceptLanguage;
@@ -287,6 +333,11 @@ bool NetworkManagerFactory::isWorkingOffline()
 	return m_isWorkingOffline;
 }
 
+bool NetworkManagerFactory::isReplayingArchive()
+{
+	return !m_replayEntries.isEmpty();
+}
+
 bool NetworkManagerFactory::isUsingSystemProxyAuthentication()
 {
 	return m_isUsingSystemProxyAuthentication;
@@ -21,6 +21,8 @@
 #ifndef OTTER_NETWORKMANAGERFACTORY_H
 #define OTTER_NETWORKMANAGERFACTORY_H
 
+#include "HttpArchive.h"
+
 #include <QtCore/QObject>
 #include <QtNetwork/QNetworkCookieJar>
 #include <QtNetwork/QNetworkDiskCache>
@@ -58,7 +60,10 @@ public:
 	static void clearCookies(int period = 0);
 	static void clearCache(int period = 0);
 	static void loadUserAgents();
+	static bool loadReplayArchive(const QString &path, int latency = 0, qint64 bandwidth = 0);
+	static QNetworkReply* createReplayReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QObject *parent);
 	static NetworkManagerFactory* getInstance();
+	static NetworkManager* getNetworkManager();
 	static CookieJar* getCookieJar();
 	static NetworkCache* getCache();
 	static QString getAcceptLanguage();
@@ -68,24 +73,30 @@ public:
 	static DoNotTrackPolicy getDoNotTrackPolicy();
 	static bool canSendReferrer();
 	static bool isWorkingOffline();
+	static bool isReplayingArchive();
 	static bool isUsingSystemProxyAuthentication();
 
 protected:
 	explicit NetworkManagerFactory(QObject *parent = NULL);
 
 	static void initialize();
+	static QString getReplayKey(const QByteArray &method, const QUrl &url);
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
 
 private:
 	static NetworkManagerFactory *m_instance;
+	static NetworkManager *m_networkManager;
 	static CookieJar *m_cookieJar;
 	static NetworkCache *m_cache;
 	static QString m_acceptLanguage;
 	static QStringList m_userAgentsOrder;
 	static QMap<QString, UserAgentInformation> m_userAgents;
 	static QList<QSslCipher> m_defaultCiphers;
+	static QHash<QString, HttpArchive::Entry> m_replayEntries;
+	static qint64 m_replayBandwidth;
+	static int m_replayLatency;
 	static DoNotTrackPolicy m_doNotTrackPolicy;
 	static bool m_canSendReferrer;
 	static bool m_isWorkingOffline;
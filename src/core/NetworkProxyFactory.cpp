@@ -19,9 +19,12 @@
 **************************************************************************/
 
 #include "Console.h"
+#include "NetworkAutomaticProxyWorker.h"
 #include "NetworkProxyFactory.h"
 #include "SettingsManager.h"
 
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtNetwork/QNetworkProxy>
 
@@ -29,7 +32,8 @@ namespace Otter
 {
 
 NetworkProxyFactory::NetworkProxyFactory() : QObject(), QNetworkProxyFactory(),
-	m_automaticProxy(NULL),
+	m_automaticProxyThread(NULL),
+	m_automaticProxyWorker(NULL),
 	m_proxyMode(SystemProxy)
 {
 	optionChanged(QLatin1String("Network/ProxyMode"));
@@ -39,9 +43,12 @@ NetworkProxyFactory::NetworkProxyFactory() : QObject(), QNetworkProxyFactory(),
 
 NetworkProxyFactory::~NetworkProxyFactory()
 {
-	if (m_automaticProxy)
+	if (m_automaticProxyThread)
 	{
-		delete m_automaticProxy;
+		m_automaticProxyThread->quit();
+		m_automaticProxyThread->wait();
+
+		delete m_automaticProxyWorker;
 	}
 }
 
@@ -51,15 +58,31 @@ void NetworkProxyFactory::optionChanged(const QString &option)
 	{
 		m_proxyMode = AutomaticProxy;
 
-		if (!m_automaticProxy)
+		if (!m_automaticProxyThread)
 		{
-			m_automaticProxy = new NetworkAutomaticProxy();
+			m_automaticProxyThread = new QThread(this);
+			m_automaticProxyWorker = new NetworkAutomaticProxyWorker();
+			m_automaticProxyWorker->moveToThread(m_automaticProxyThread);
+			m_automaticProxyThread->start();
+
+			connect(m_automaticProxyWorker, SIGNAL(proxyEvaluated(QString,QList<QNetworkProxy>)), this, SLOT(storeAutomaticProxy(QString,QList<QNetworkProxy>)), Qt::DirectConnection);
 		}
 
 		const QString path = SettingsManager::getValue(QLatin1String("Proxy/AutomaticConfigurationPath")).toString();
 		QFile file(path);
+		bool isValid = false;
+
+		if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			QMetaObject::invokeMethod(m_automaticProxyWorker, "setup", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, isValid), Q_ARG(QString, QString(file.readAll())));
+		}
+
+		m_automaticProxiesMutex.lock();
+		m_automaticProxies.clear();
+		m_pendingAutomaticProxies.clear();
+		m_automaticProxiesMutex.unlock();
 
-		if (!file.open(QIODevice::ReadOnly | QIODevice::Text) || !m_automaticProxy->setup(file.readAll()))
+		if (!isValid)
 		{
 			Console::addMessage(tr("Failed to setup proxy auto-config (PAC)"), NetworkMessageCategory, ErrorMessageLevel, path);
 
@@ -143,13 +166,80 @@ QList<QNetworkProxy> NetworkProxyFactory::queryProxy(const QNetworkProxyQuery &q
 		}
 	}
 
-	if (m_proxyMode == AutomaticProxy && m_automaticProxy)
+	if (m_proxyMode == AutomaticProxy && m_automaticProxyWorker)
 	{
-		return m_automaticProxy->getProxy(query.url().toString(), query.peerHostName());
+		return getAutomaticProxy(query);
 	}
 
 	return m_proxies[QLatin1String("NoProxy")];
 }
 
+QList<QNetworkProxy> NetworkProxyFactory::getAutomaticProxy(const QNetworkProxyQuery &query)
+{
+	const QString key = (query.url().scheme() + QLatin1String("://") + query.peerHostName().toLower());
+	QMutexLocker locker(&m_automaticProxiesMutex);
+
+	if (m_automaticProxies.contains(key) && m_automaticProxies[key].second > QDateTime::currentMSecsSinceEpoch())
+	{
+		return m_automaticProxies[key].first;
+	}
+
+	if (!m_pendingAutomaticProxies.contains(key))
+	{
+		m_pendingAutomaticProxies.insert(key);
+
+		QMetaObject::invokeMethod(m_automaticProxyWorker, "evaluate", Qt::QueuedConnection, Q_ARG(QString, query.url().toString()), Q_ARG(QString, query.peerHostName()), Q_ARG(QString, key));
+	}
+
+	if (m_automaticProxies.contains(key))
+	{
+		return m_automaticProxies[key].first;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	while (!m_automaticProxies.contains(key) && timer.elapsed() < 500)
+	{
+		m_automaticProxiesCondition.wait(&m_automaticProxiesMutex, (500 - timer.elapsed()));
+	}
+
+	if (m_automaticProxies.contains(key))
+	{
+		return m_automaticProxies[key].first;
+	}
+
+// never go direct only because evaluation did not finish in time, fail the request instead, repeated one will use the answer stored for this host
+	return QList<QNetworkProxy>();
+}
+
+void NetworkProxyFactory::storeAutomaticProxy(const QString &key, const QList<QNetworkProxy> &proxies)
+{
+	QMutexLocker locker(&m_automaticProxiesMutex);
+	const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+
+	if (m_automaticProxies.count() > 1000)
+	{
+		QHash<QString, QPair<QList<QNetworkProxy>, qint64> >::iterator iterator = m_automaticProxies.begin();
+
+		while (iterator != m_automaticProxies.end())
+		{
+			if (iterator.value().second <= currentTime)
+			{
+				iterator = m_automaticProxies.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+	}
+
+	m_automaticProxies[key] = qMakePair(proxies, (currentTime + 300000));
+
+	m_pendingAutomaticProxies.remove(key);
+	m_automaticProxiesCondition.wakeAll();
+}
+
 }
 
@@ -21,13 +21,17 @@
 #ifndef OTTER_NETWORKPROXYFACTORY_H
 #define OTTER_NETWORKPROXYFACTORY_H
 
-#include "NetworkAutomaticProxy.h"
-
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
 #include <QtNetwork/QNetworkProxy>
 
 namespace Otter
 {
 
+class NetworkAutomaticProxyWorker;
+
 class NetworkProxyFactory : public QObject, public QNetworkProxyFactory
 {
 	Q_OBJECT
@@ -47,11 +51,20 @@ public:
 
 	QList<QNetworkProxy> queryProxy(const QNetworkProxyQuery &query);
 
+protected:
+	QList<QNetworkProxy> getAutomaticProxy(const QNetworkProxyQuery &query);
+
 protected slots:
 	void optionChanged(const QString &option);
+	void storeAutomaticProxy(const QString &key, const QList<QNetworkProxy> &proxies);
 
 private:
-	NetworkAutomaticProxy *m_automaticProxy;
+	QThread *m_automaticProxyThread;
+	NetworkAutomaticProxyWorker *m_automaticProxyWorker;
+	QMutex m_automaticProxiesMutex;
+	QWaitCondition m_automaticProxiesCondition;
+	QHash<QString, QPair<QList<QNetworkProxy>, qint64> > m_automaticProxies;
+	QSet<QString> m_pendingAutomaticProxies;
 	QHash<QString, QList<QNetworkProxy> > m_proxies;
 	ProxyMode m_proxyMode;
 };
@@ -0,0 +1,168 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PageLoadBenchmark.h"
+#include "Action.h"
+#include "AddonsManager.h"
+#include "WebBackend.h"
+#include "../ui/WebWidget.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+PageLoadBenchmark::PageLoadBenchmark(const QString &path, QObject *parent) : QObject(parent),
+	m_widget(NULL),
+	m_totalTime(0),
+	m_currentUrl(-1),
+	m_failedLoads(0),
+	m_timeoutTimer(0),
+	m_isLoading(false)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return;
+	}
+
+	QTextStream stream(&file);
+
+	while (!stream.atEnd())
+	{
+		const QString line = stream.readLine().trimmed();
+
+		if (!line.isEmpty() && !line.startsWith(QLatin1Char('#')))
+		{
+			m_urls.append(line);
+		}
+	}
+}
+
+PageLoadBenchmark::~PageLoadBenchmark()
+{
+	delete m_widget;
+}
+
+void PageLoadBenchmark::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_timeoutTimer)
+	{
+		reportLoad(true);
+	}
+}
+
+void PageLoadBenchmark::start()
+{
+	m_widget = AddonsManager::getWebBackend()->createWidget(true);
+
+	connect(m_widget, SIGNAL(loadingChanged(bool)), this, SLOT(loadingChanged(bool)));
+
+	QTextStream(stdout) << "url\ttime [ms]\trequests\tcached\tbytes" << endl;
+
+	loadNext();
+}
+
+void PageLoadBenchmark::loadNext()
+{
+	++m_currentUrl;
+
+	if (m_currentUrl >= m_urls.count())
+	{
+		QTextStream(stdout) << "total\t" << m_totalTime << "\t" << (m_urls.count() - m_failedLoads) << " of " << m_urls.count() << " loaded" << endl;
+
+		QCoreApplication::exit((m_failedLoads > 0) ? 1 : 0);
+
+		return;
+	}
+
+	m_isLoading = false;
+	m_timeoutTimer = startTimer(60000);
+	m_loadTimer.start();
+	m_widget->setUrl(QUrl::fromUserInput(m_urls.at(m_currentUrl)), false);
+}
+
+void PageLoadBenchmark::loadingChanged(bool isLoading)
+{
+	if (isLoading)
+	{
+		m_isLoading = true;
+	}
+	else if (m_isLoading)
+	{
+		reportLoad(false);
+	}
+}
+
+void PageLoadBenchmark::reportLoad(bool isTimedOut)
+{
+	const qint64 time = m_loadTimer.elapsed();
+
+	killTimer(m_timeoutTimer);
+
+	m_timeoutTimer = 0;
+	m_isLoading = false;
+
+	const QList<HttpArchive::Entry> timeline = m_widget->getTimeline();
+	qint64 bytesReceived = 0;
+	int cachedRequests = 0;
+
+	for (int i = 0; i < timeline.count(); ++i)
+	{
+		bytesReceived += timeline.at(i).bytesReceived;
+
+		if (timeline.at(i).isFromCache)
+		{
+			++cachedRequests;
+		}
+	}
+
+	QTextStream stream(stdout);
+	stream << m_urls.at(m_currentUrl) << "\t";
+
+	if (isTimedOut)
+	{
+		m_widget->triggerAction(Action::StopAction);
+
+		++m_failedLoads;
+
+		stream << "timeout";
+	}
+	else
+	{
+		m_totalTime += time;
+
+		stream << time;
+	}
+
+	stream << "\t" << timeline.count() << "\t" << cachedRequests << "\t" << bytesReceived << endl;
+
+	QMetaObject::invokeMethod(this, "loadNext", Qt::QueuedConnection);
+}
+
+bool PageLoadBenchmark::isValid() const
+{
+	return !m_urls.isEmpty();
+}
+
+}
@@ -0,0 +1,64 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PAGELOADBENCHMARK_H
+#define OTTER_PAGELOADBENCHMARK_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+namespace Otter
+{
+
+class WebWidget;
+
+class PageLoadBenchmark : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit PageLoadBenchmark(const QString &path, QObject *parent = NULL);
+	~PageLoadBenchmark();
+
+	void start();
+	bool isValid() const;
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	void reportLoad(bool isTimedOut);
+
+protected slots:
+	void loadNext();
+	void loadingChanged(bool isLoading);
+
+private:
+	WebWidget *m_widget;
+	QElapsedTimer m_loadTimer;
+	QStringList m_urls;
+	qint64 m_totalTime;
+	int m_currentUrl;
+	int m_failedLoads;
+	int m_timeoutTimer;
+	bool m_isLoading;
+};
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ReplayNetworkReply.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+ReplayNetworkReply::ReplayNetworkReply(QObject *parent, const QNetworkRequest &request, const HttpArchive::Entry &entry, int latency, qint64 bandwidth) : QNetworkReply(parent),
+	m_content(entry.body),
+	m_offset(0),
+	m_bytesReceived(0),
+	m_bandwidth(bandwidth),
+	m_timer(0),
+	m_isStarted(false)
+{
+	setRequest(request);
+	setUrl(request.url());
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	if (entry.status > 0)
+	{
+		for (int i = 0; i < entry.responseHeaders.count(); ++i)
+		{
+			const QByteArray name = entry.responseHeaders.at(i).first.toLower();
+
+			if (name == "content-encoding" || name == "content-length" || name == "transfer-encoding")
+			{
+				continue;
+			}
+
+			setRawHeader(entry.responseHeaders.at(i).first, entry.responseHeaders.at(i).second);
+
+			if (name == "location" && entry.status >= 300 && entry.status < 400)
+			{
+				setAttribute(QNetworkRequest::RedirectionTargetAttribute, QUrl(QString::fromLatin1(entry.responseHeaders.at(i).second)));
+			}
+		}
+
+		if (header(QNetworkRequest::ContentTypeHeader).isNull() && !entry.mimeType.isEmpty())
+		{
+			setHeader(QNetworkRequest::ContentTypeHeader, QVariant(entry.mimeType));
+		}
+
+		setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, entry.status);
+	}
+	else
+	{
+		m_content.clear();
+
+		setError(QNetworkReply::ContentNotFoundError, tr("Resource is not available in replayed archive"));
+	}
+
+	m_timer = startTimer(qMax(0, latency));
+}
+
+void ReplayNetworkReply::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timer)
+	{
+		QNetworkReply::timerEvent(event);
+
+		return;
+	}
+
+	if (!m_isStarted)
+	{
+		m_isStarted = true;
+
+		killTimer(m_timer);
+
+		m_timer = ((m_bandwidth > 0) ? startTimer(50) : 0);
+
+		emit metaDataChanged();
+
+		if (error() != QNetworkReply::NoError)
+		{
+			emit error(error());
+
+			finish();
+
+			return;
+		}
+	}
+
+	const qint64 size = m_content.size();
+
+	m_bytesReceived = ((m_bandwidth > 0) ? qMin(size, (m_bytesReceived + qMax((qint64) 1, (m_bandwidth / 20)))) : size);
+
+	if (size > 0)
+	{
+		emit downloadProgress(m_bytesReceived, size);
+		emit readyRead();
+	}
+
+	if (m_bytesReceived >= size)
+	{
+		finish();
+	}
+}
+
+void ReplayNetworkReply::finish()
+{
+	if (m_timer != 0)
+	{
+		killTimer(m_timer);
+
+		m_timer = 0;
+	}
+
+	if (isFinished())
+	{
+		return;
+	}
+
+	setFinished(true);
+
+	emit finished();
+}
+
+void ReplayNetworkReply::abort()
+{
+	if (isFinished())
+	{
+		return;
+	}
+
+	setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+
+	emit error(QNetworkReply::OperationCanceledError);
+
+	finish();
+}
+
+qint64 ReplayNetworkReply::bytesAvailable() const
+{
+	return ((m_bytesReceived - m_offset) + QNetworkReply::bytesAvailable());
+}
+
+qint64 ReplayNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_bytesReceived)
+	{
+		const qint64 number = qMin(maxSize, (m_bytesReceived - m_offset));
+
+		memcpy(data, (m_content.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return (isFinished() ? -1 : 0);
+}
+
+bool ReplayNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -18,6 +18,8 @@
 **************************************************************************/
 
 #include "core/Application.h"
+#include "core/NetworkManagerFactory.h"
+#include "core/PageLoadBenchmark.h"
 #include "core/SessionsManager.h"
 #include "core/SettingsManager.h"
 #include "ui/MainWindow.h"
@@ -78,6 +80,33 @@ int main(int argc, char *argv[])
 	QCommandLineParser *parser = application.createCommandLineParser();
 	parser->process(application);
 
+	if (parser->isSet(QLatin1String("replay")) && !NetworkManagerFactory::loadReplayArchive(parser->value(QLatin1String("replay")), parser->value(QLatin1String("replay-latency")).toInt(), (parser->value(QLatin1String("replay-bandwidth")).toLongLong() * 1024)))
+	{
+		fprintf(stderr, "Failed to load replay archive: %s\n", parser->value(QLatin1String("replay")).toLocal8Bit().constData());
+
+		delete parser;
+
+		return 1;
+	}
+
+	if (parser->isSet(QLatin1String("benchmark")))
+	{
+		PageLoadBenchmark benchmark(parser->value(QLatin1String("benchmark")));
+
+		delete parser;
+
+		if (!benchmark.isValid())
+		{
+			fprintf(stderr, "No URLs to benchmark\n");
+
+			return 1;
+		}
+
+		benchmark.start();
+
+		return application.exec();
+	}
+
 	const QString session = (parser->value(QLatin1String("session")).isEmpty() ? QLatin1String("default") : parser->value(QLatin1String("session")));
 	const QString startupBehavior = SettingsManager::getValue(QLatin1String("Browser/StartupBehavior")).toString();
 	const bool isPrivate = parser->isSet(QLatin1String("privatesession"));
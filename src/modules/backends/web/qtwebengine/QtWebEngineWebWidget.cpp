@@ -1642,6 +1642,7 @@ Action* QtWebEngineWebWidget::getAction(int identifier)
 		case Action::InspectPageAction:
 		case Action::InspectElementAction:
 		case Action::LoadPluginsAction:
+		case Action::WebsiteInformationAction:
 			action->setEnabled(false);
 
 			break;
@@ -1875,6 +1876,11 @@ QVariantHash QtWebEngineWebWidget::getStatistics() const
 	return QVariantHash();
 }
 
+QList<HttpArchive::Entry> QtWebEngineWebWidget::getTimeline() const
+{
+	return QList<HttpArchive::Entry>();
+}
+
 int QtWebEngineWebWidget::getZoom() const
 {
 	return (m_webView->zoomFactor() * 100);
@@ -98,6 +98,7 @@ public:
 	WindowHistoryInformation getHistory() const;
 	QHash<QByteArray, QByteArray> getHeaders() const;
 	QVariantHash getStatistics() const;
+	QList<HttpArchive::Entry> getTimeline() const;
 	int getZoom() const;
 	bool isLoading() const;
 	bool isPrivate() const;
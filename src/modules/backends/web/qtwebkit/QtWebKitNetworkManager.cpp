@@ -47,10 +47,13 @@ QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitWebWidget
 	m_bytesTotal(0),
 	m_finishedRequests(0),
 	m_startedRequests(0),
+	m_timelineOffset(0),
 	m_updateTimer(0),
 	m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy),
 	m_canSendReferrer(true)
 {
+	resetTimeline();
+
 	connect(this, SIGNAL(finished(QNetworkReply*)), SLOT(requestFinished(QNetworkReply*)));
 }
 
@@ -210,10 +213,43 @@ void QtWebKitNetworkManager::resetStatistics()
 	m_startedRequests = 0;
 }
 
+void QtWebKitNetworkManager::resetTimeline()
+{
+	m_timeline.clear();
+	m_timelineEntries.clear();
+	m_timelineTimer.start();
+
+	m_timelineDateTime = QDateTime::currentDateTime();
+	m_timelineOffset = 0;
+}
+
+void QtWebKitNetworkManager::addTimelineEntry(const HttpArchive::Entry &entry)
+{
+	if (m_timeline.count() >= 1000)
+	{
+		m_timeline.removeFirst();
+
+		++m_timelineOffset;
+	}
+
+	m_timeline.append(entry);
+}
+
 void QtWebKitNetworkManager::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
 	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
 
+	if (reply && m_timelineEntries.contains(reply) && m_timelineEntries[reply] >= m_timelineOffset)
+	{
+		HttpArchive::Entry &entry = m_timeline[m_timelineEntries[reply] - m_timelineOffset];
+		entry.bytesReceived = bytesReceived;
+
+		if (entry.firstByteTime < 0)
+		{
+			entry.firstByteTime = m_timelineTimer.elapsed();
+		}
+	}
+
 	if (reply && reply == m_baseReply)
 	{
 		if (m_baseReply->hasRawHeader(QStringLiteral("Location").toLatin1()))
@@ -264,6 +300,23 @@ void QtWebKitNetworkManager::requestFinished(QNetworkReply *reply)
 {
 	m_replies.remove(reply);
 
+	const int index = (m_timelineEntries.contains(reply) ? (m_timelineEntries.take(reply) - m_timelineOffset) : -1);
+
+	if (reply && index >= 0)
+	{
+		HttpArchive::Entry &entry = m_timeline[index];
+		entry.finishTime = m_timelineTimer.elapsed();
+		entry.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+		entry.responseHeaders = reply->rawHeaderPairs();
+		entry.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		entry.isFromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+
+		if (entry.firstByteTime < 0)
+		{
+			entry.firstByteTime = entry.finishTime;
+		}
+	}
+
 	if (m_replies.isEmpty())
 	{
 		killTimer(m_updateTimer);
@@ -328,8 +381,13 @@ void QtWebKitNetworkManager::setWidget(QtWebKitWebWidget *widget)
 
 QtWebKitNetworkManager* QtWebKitNetworkManager::clone()
 {
-	QtWebKitNetworkManager *manager = new QtWebKitNetworkManager((cache() == NULL), NULL);
-	manager->setCookieJar(getCookieJar()->clone(manager));
+	const bool isPrivate = (cache() == NULL);
+	QtWebKitNetworkManager *manager = new QtWebKitNetworkManager(isPrivate, NULL);
+
+	if (isPrivate)
+	{
+		manager->setCookieJar(getCookieJar()->clone(manager));
+	}
 
 	return manager;
 }
@@ -347,10 +405,21 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	++m_startedRequests;
 
+	HttpArchive::Entry entry;
+	entry.url = request.url();
+	entry.method = HttpArchive::getMethod(operation, request);
+	entry.queuedTime = m_timelineTimer.elapsed();
+	entry.startDateTime = m_timelineDateTime.addMSecs(entry.queuedTime);
+
 	if (ContentBlockingManager::isUrlBlocked(m_widget->getContentBlockingProfiles(), request, m_widget->getUrl()))
 	{
 		Console::addMessage(QCoreApplication::translate("main", "Blocked content: %1").arg(request.url().url()), Otter::NetworkMessageCategory, LogMessageLevel);
 
+		entry.finishTime = entry.queuedTime;
+		entry.isBlocked = true;
+
+		addTimelineEntry(entry);
+
 		QUrl url = QUrl();
 		url.setScheme(QLatin1String("http"));
 
@@ -387,7 +456,19 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	emit messageChanged(tr("Sending request to %1…").arg(request.url().host()));
 
-	QNetworkReply *reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
+	QNetworkReply *reply = createSharedRequest(operation, mutableRequest, outgoingData);
+	const QList<QByteArray> headers = mutableRequest.rawHeaderList();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		entry.requestHeaders.append(qMakePair(headers.at(i), mutableRequest.rawHeader(headers.at(i))));
+	}
+
+	entry.startTime = m_timelineTimer.elapsed();
+
+	m_timelineEntries[reply] = (m_timelineOffset + m_timeline.count());
+
+	addTimelineEntry(entry);
 
 	if (!m_baseReply)
 	{
@@ -396,6 +477,8 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(QNetworkAccessManager::Oper
 
 	m_replies[reply] = qMakePair(0, false);
 
+	trackReply(reply);
+
 	connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
 
 	if (m_updateTimer == 0)
@@ -423,6 +506,11 @@ QHash<QByteArray, QByteArray> QtWebKitNetworkManager::getHeaders() const
 	return headers;
 }
 
+QList<HttpArchive::Entry> QtWebKitNetworkManager::getTimeline() const
+{
+	return m_timeline;
+}
+
 QVariantHash QtWebKitNetworkManager::getStatistics() const
 {
 	QVariantHash statistics;
@@ -20,9 +20,11 @@
 #ifndef OTTER_QTWEBKITNETWORKMANAGER_H
 #define OTTER_QTWEBKITNETWORKMANAGER_H
 
+#include "../../../../core/HttpArchive.h"
 #include "../../../../core/NetworkManager.h"
 #include "../../../../core/NetworkManagerFactory.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtNetwork/QNetworkRequest>
 
 namespace Otter
@@ -39,10 +41,13 @@ public:
 
 	QHash<QByteArray, QByteArray> getHeaders() const;
 	QVariantHash getStatistics() const;
+	QList<HttpArchive::Entry> getTimeline() const;
 
 protected:
 	void timerEvent(QTimerEvent *event);
 	void resetStatistics();
+	void resetTimeline();
+	void addTimelineEntry(const HttpArchive::Entry &entry);
 	void updateStatus();
 	void updateOptions(const QUrl &url);
 	void setFormRequest(const QUrl &url);
@@ -62,13 +67,18 @@ private:
 	QNetworkReply *m_baseReply;
 	QString m_acceptLanguage;
 	QUrl m_formRequestUrl;
+	QDateTime m_timelineDateTime;
+	QElapsedTimer m_timelineTimer;
 	QHash<QNetworkReply*, QPair<qint64, bool> > m_replies;
+	QHash<QNetworkReply*, int> m_timelineEntries;
+	QList<HttpArchive::Entry> m_timeline;
 	qint64 m_speed;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
 	int m_finishedRequests;
 	int m_startedRequests;
+	int m_timelineOffset;
 	int m_updateTimer;
 	NetworkManagerFactory::DoNotTrackPolicy m_doNotTrackPolicy;
 	bool m_canSendReferrer;
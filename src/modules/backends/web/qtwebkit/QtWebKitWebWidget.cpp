@@ -29,6 +29,7 @@
 #include "../../../../core/Console.h"
 #include "../../../../core/CookieJar.h"
 #include "../../../../core/ContentBlockingManager.h"
+#include "../../../../core/FaviconsCache.h"
 #include "../../../../core/GesturesManager.h"
 #include "../../../../core/HistoryManager.h"
 #include "../../../../core/InputInterpreter.h"
@@ -45,6 +46,7 @@
 #include "../../../../ui/ContentsWidget.h"
 #include "../../../../ui/MainWindow.h"
 #include "../../../../ui/SearchPropertiesDialog.h"
+#include "../../../../ui/WebsiteInformationDialog.h"
 #include "../../../../ui/WebsitePreferencesDialog.h"
 
 #include <QtCore/QDataStream>
@@ -248,6 +250,8 @@ void QtWebKitWebWidget::pageLoadStarted()
 	m_isLoading = true;
 	m_thumbnail = QPixmap();
 
+	m_networkManager->resetTimeline();
+
 	updateNavigationActions();
 	setStatusMessage(QString());
 	setStatusMessage(QString(), true);
@@ -280,9 +284,9 @@ void QtWebKitWebWidget::downloadFile(const QNetworkRequest &request)
 	{
 		NetworkCache *cache = NetworkManagerFactory::getCache();
 
-		if (cache && cache->metaData(request.url()).isValid())
+		if (cache && cache->getEntry(request.url()).metaData.isValid())
 		{
-			QIODevice *device = cache->data(request.url());
+			QIODevice *device = cache->getEntryData(request.url());
 
 			if (device && device->size() > 0)
 			{
@@ -572,6 +576,8 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 
 void QtWebKitWebWidget::notifyIconChanged()
 {
+	FaviconsCache::invalidate(getUrl());
+
 	emit iconChanged(getIcon());
 }
 
@@ -635,6 +641,11 @@ void QtWebKitWebWidget::updatePageActions(const QUrl &url)
 	{
 		m_actions[Action::WebsitePreferencesAction]->setEnabled(!url.isEmpty() && url.scheme() != QLatin1String("about"));
 	}
+
+	if (m_actions.contains(Action::WebsiteInformationAction))
+	{
+		m_actions[Action::WebsiteInformationAction]->setEnabled(!url.isEmpty() && url.scheme() != QLatin1String("about"));
+	}
 }
 
 void QtWebKitWebWidget::updateNavigationActions()
@@ -1252,7 +1263,7 @@ void QtWebKitWebWidget::triggerAction(int identifier, bool checked)
 				}
 
 				ContentsWidget *parent = qobject_cast<ContentsWidget*>(parentWidget());
-				ImagePropertiesDialog *imagePropertiesDialog = new ImagePropertiesDialog(m_hitResult.imageUrl(), properties, (m_networkManager->cache() ? m_networkManager->cache()->data(m_hitResult.imageUrl()) : NULL), this);
+				ImagePropertiesDialog *imagePropertiesDialog = new ImagePropertiesDialog(m_hitResult.imageUrl(), properties, (NetworkManagerFactory::getCache() ? NetworkManagerFactory::getCache()->getEntryData(m_hitResult.imageUrl()) : NULL), this);
 				imagePropertiesDialog->setButtonsVisible(false);
 
 				if (parent)
@@ -1705,6 +1716,13 @@ void QtWebKitWebWidget::triggerAction(int identifier, bool checked)
 				}
 			}
 
+			break;
+		case Action::WebsiteInformationAction:
+			{
+				WebsiteInformationDialog dialog(this, this);
+				dialog.exec();
+			}
+
 			break;
 		default:
 			break;
@@ -2044,6 +2062,7 @@ Action* QtWebKitWebWidget::getAction(int identifier)
 			break;
 		case Action::AddBookmarkAction:
 		case Action::WebsitePreferencesAction:
+		case Action::WebsiteInformationAction:
 			updatePageActions(getUrl());
 
 			break;
@@ -2215,6 +2234,11 @@ QVariantHash QtWebKitWebWidget::getStatistics() const
 	return m_networkManager->getStatistics();
 }
 
+QList<HttpArchive::Entry> QtWebKitWebWidget::getTimeline() const
+{
+	return m_networkManager->getTimeline();
+}
+
 QUrl QtWebKitWebWidget::getUrl() const
 {
 	const QUrl url = m_webView->url();
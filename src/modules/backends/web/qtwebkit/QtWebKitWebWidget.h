@@ -61,6 +61,7 @@ public:
 	QVector<int> getContentBlockingProfiles();
 	QHash<QByteArray, QByteArray> getHeaders() const;
 	QVariantHash getStatistics() const;
+	QList<HttpArchive::Entry> getTimeline() const;
 	int getZoom() const;
 	bool isLoading() const;
 	bool isPrivate() const;
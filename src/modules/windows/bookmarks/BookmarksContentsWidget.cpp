@@ -19,6 +19,7 @@
 
 #include "BookmarksContentsWidget.h"
 #include "../../../core/ActionsManager.h"
+#include "../../../core/BookmarksFilterModel.h"
 #include "../../../core/BookmarksModel.h"
 #include "../../../core/SettingsManager.h"
 #include "../../../core/Utils.h"
@@ -38,6 +39,7 @@ namespace Otter
 {
 
 BookmarksContentsWidget::BookmarksContentsWidget(Window *window) : ContentsWidget(window),
+	m_model(new BookmarksFilterModel(BookmarksManager::getModel(), this)),
 	m_ui(new Ui::BookmarksContentsWidget)
 {
 	m_ui->setupUi(this);
@@ -48,9 +50,9 @@ BookmarksContentsWidget::BookmarksContentsWidget(Window *window) : ContentsWidge
 	addMenu->addAction(tr("Add Separator"), this, SLOT(addSeparator()));
 
 	m_ui->addButton->setMenu(addMenu);
-	m_ui->bookmarksView->setModel(BookmarksManager::getModel());
+	m_ui->bookmarksView->setModel(m_model);
 	m_ui->bookmarksView->setItemDelegate(new ItemDelegate(this));
-	m_ui->bookmarksView->setExpanded(BookmarksManager::getModel()->getRootItem()->index(), true);
+	m_ui->bookmarksView->setExpanded(m_model->getIndex(BookmarksManager::getModel()->getRootItem()), true);
 	m_ui->bookmarksView->viewport()->installEventFilter(this);
 
 	connect(BookmarksManager::getModel(), SIGNAL(modelReset()), this, SLOT(updateActions()));
@@ -112,7 +114,7 @@ void BookmarksContentsWidget::addSeparator()
 
 void BookmarksContentsWidget::removeBookmark()
 {
-	QStandardItem *bookmark = BookmarksManager::getModel()->itemFromIndex(m_ui->bookmarksView->currentIndex());
+	QStandardItem *bookmark = m_model->getItem(m_ui->bookmarksView->currentIndex());
 	const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(m_ui->bookmarksView->currentIndex().data(BookmarksModel::TypeRole).toInt());
 
 	if (bookmark && type != BookmarksItem::RootBookmark && type != BookmarksItem::TrashBookmark)
@@ -133,7 +135,7 @@ void BookmarksContentsWidget::removeBookmark()
 
 void BookmarksContentsWidget::restoreBookmark()
 {
-	QStandardItem *bookmark = BookmarksManager::getModel()->itemFromIndex(m_ui->bookmarksView->currentIndex());
+	QStandardItem *bookmark = m_model->getItem(m_ui->bookmarksView->currentIndex());
 	QStandardItem *formerParent = (m_trash.contains(bookmark) ? BookmarksManager::getModel()->itemFromIndex(m_trash[bookmark].first) : BookmarksManager::getModel()->getRootItem());
 
 	if (!formerParent || static_cast<BookmarksItem::BookmarkType>(formerParent->data(BookmarksModel::TypeRole).toInt()) != BookmarksItem::FolderBookmark)
@@ -160,7 +162,7 @@ void BookmarksContentsWidget::restoreBookmark()
 
 void BookmarksContentsWidget::openBookmark(const QModelIndex &index)
 {
-	BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(BookmarksManager::getModel()->itemFromIndex(index.isValid() ? index : m_ui->bookmarksView->currentIndex()));
+	BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(m_model->getItem(index.isValid() ? index : m_ui->bookmarksView->currentIndex()));
 	WindowsManager *manager = SessionsManager::getWindowsManager();
 
 	if (bookmark && manager)
@@ -181,7 +183,7 @@ void BookmarksContentsWidget::copyBookmarkLink()
 
 void BookmarksContentsWidget::bookmarkProperties()
 {
-	BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(BookmarksManager::getModel()->itemFromIndex(m_ui->bookmarksView->currentIndex()));
+	BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(m_model->getItem(m_ui->bookmarksView->currentIndex()));
 
 	if (bookmark)
 	{
@@ -355,7 +357,7 @@ Action* BookmarksContentsWidget::getAction(int identifier)
 
 QStandardItem* BookmarksContentsWidget::findFolder(const QModelIndex &index)
 {
-	QStandardItem *item = BookmarksManager::getModel()->itemFromIndex(index);
+	QStandardItem *item = m_model->getItem(index);
 
 	if (!item || item == BookmarksManager::getModel()->getRootItem() || item == BookmarksManager::getModel()->getTrashItem())
 	{
@@ -387,46 +389,18 @@ QIcon BookmarksContentsWidget::getIcon() const
 	return Utils::getIcon(QLatin1String("bookmarks"), false);
 }
 
-bool BookmarksContentsWidget::filterBookmarks(const QString &filter, QStandardItem *branch)
+void BookmarksContentsWidget::filterBookmarks(const QString &filter)
 {
-	if (!branch)
-	{
-		if (sender())
-		{
-			branch = BookmarksManager::getModel()->invisibleRootItem();
-		}
-		else
-		{
-			return false;
-		}
-	}
+	m_model->setFilter(filter);
 
-	bool found = filter.isEmpty();
-
-	for (int i = 0; i < branch->rowCount(); ++i)
+	if (filter.isEmpty())
 	{
-		QStandardItem *item = branch->child(i, 0);
-
-		if (item && filterBookmarks(filter, item))
-		{
-			found = true;
-		}
+		m_ui->bookmarksView->collapseAll();
 	}
-
-	if (!found)
+	else
 	{
-		const BookmarksItem::BookmarkType type = static_cast<BookmarksItem::BookmarkType>(branch->data(BookmarksModel::TypeRole).toInt());
-
-		if ((type == BookmarksItem::FolderBookmark || type == BookmarksItem::UrlBookmark) && (branch->data(BookmarksModel::UrlRole).toString().contains(filter, Qt::CaseInsensitive) || branch->data(BookmarksModel::TitleRole).toString().contains(filter, Qt::CaseInsensitive) || branch->data(BookmarksModel::DescriptionRole).toString().contains(filter, Qt::CaseInsensitive) || branch->data(BookmarksModel::KeywordRole).toString().contains(filter, Qt::CaseInsensitive)))
-		{
-			found = true;
-		}
+		m_ui->bookmarksView->expandAll();
 	}
-
-	m_ui->bookmarksView->setRowHidden(branch->row(), branch->index().parent(), !found);
-	m_ui->bookmarksView->setExpanded(branch->index(), (found && !filter.isEmpty()));
-
-	return found;
 }
 
 bool BookmarksContentsWidget::isInTrash(const QModelIndex &index) const
@@ -462,7 +436,7 @@ bool BookmarksContentsWidget::eventFilter(QObject *object, QEvent *event)
 
 		if (mouseEvent && ((mouseEvent->button() == Qt::LeftButton && mouseEvent->modifiers() != Qt::NoModifier) || mouseEvent->button() == Qt::MiddleButton))
 		{
-			BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(BookmarksManager::getModel()->itemFromIndex(m_ui->bookmarksView->indexAt(mouseEvent->pos())));
+			BookmarksItem *bookmark = dynamic_cast<BookmarksItem*>(m_model->getItem(m_ui->bookmarksView->indexAt(mouseEvent->pos())));
 
 			if (bookmark)
 			{
@@ -33,6 +33,7 @@ namespace Ui
 	class BookmarksContentsWidget;
 }
 
+class BookmarksFilterModel;
 class Window;
 
 class BookmarksContentsWidget : public ContentsWidget
@@ -72,11 +73,12 @@ protected slots:
 	void emptyTrash();
 	void showContextMenu(const QPoint &point);
 	void updateActions();
-	bool filterBookmarks(const QString &filter, QStandardItem *branch = NULL);
+	void filterBookmarks(const QString &filter);
 
 private:
 	QHash<int, Action*> m_actions;
 	QHash<QStandardItem*, QPair<QModelIndex, int> > m_trash;
+	BookmarksFilterModel *m_model;
 	Ui::BookmarksContentsWidget *m_ui;
 };
 
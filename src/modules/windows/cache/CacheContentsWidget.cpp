@@ -19,18 +19,16 @@
 
 #include "CacheContentsWidget.h"
 #include "../../../core/ActionsManager.h"
-#include "../../../core/AddonsManager.h"
 #include "../../../core/NetworkCache.h"
+#include "../../../core/NetworkCacheModel.h"
 #include "../../../core/NetworkManagerFactory.h"
 #include "../../../core/Utils.h"
-#include "../../../core/WebBackend.h"
 #include "../../../ui/ItemDelegate.h"
 
 #include "ui_CacheContentsWidget.h"
 
 #include <QtCore/QDateTime>
 #include <QtCore/QMimeDatabase>
-#include <QtCore/QTimer>
 #include <QtGui/QClipboard>
 #include <QtGui/QMouseEvent>
 #include <QtWidgets/QMenu>
@@ -39,19 +37,30 @@ namespace Otter
 {
 
 CacheContentsWidget::CacheContentsWidget(Window *window) : ContentsWidget(window),
-	m_model(new QStandardItemModel(this)),
-	m_isLoading(true),
+	m_model(new NetworkCacheModel(this)),
 	m_ui(new Ui::CacheContentsWidget)
 {
 	m_ui->setupUi(this);
 	m_ui->previewLabel->hide();
+	m_ui->cacheView->setModel(m_model);
+	m_ui->cacheView->setItemDelegate(new ItemDelegate(this));
+	m_ui->cacheView->setSortingEnabled(true);
+	m_ui->cacheView->sortByColumn(0, Qt::AscendingOrder);
+	m_ui->cacheView->header()->setTextElideMode(Qt::ElideRight);
+	m_ui->cacheView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
 	m_ui->cacheView->viewport()->installEventFilter(this);
 
-	QTimer::singleShot(100, this, SLOT(populateCache()));
+	NetworkCache *cache = NetworkManagerFactory::getCache();
 
+	connect(cache, SIGNAL(cleared()), this, SLOT(updateStatistics()));
+	connect(cache, SIGNAL(entryAdded(QUrl)), this, SLOT(updateStatistics()));
+	connect(cache, SIGNAL(entryRemoved(QUrl)), this, SLOT(updateStatistics()));
+	connect(m_model, SIGNAL(modelLoaded()), this, SLOT(updateLoading()));
+	connect(m_model, SIGNAL(modelReset()), this, SLOT(updateActions()));
 	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterCache(QString)));
 	connect(m_ui->cacheView, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(openEntry(QModelIndex)));
 	connect(m_ui->cacheView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showContextMenu(QPoint)));
+	connect(m_ui->cacheView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(updateActions()));
 	connect(m_ui->deleteButton, SIGNAL(clicked()), this, SLOT(removeDomainEntriesOrEntry()));
 }
 
@@ -100,198 +109,24 @@ void CacheContentsWidget::triggerAction()
 	}
 }
 
-void CacheContentsWidget::populateCache()
+void CacheContentsWidget::updateLoading()
 {
-	NetworkCache *cache = NetworkManagerFactory::getCache();
-	QStringList labels;
-	labels << tr("Address") << tr("Type") << tr("Size") << tr("Last Modified") << tr("Expires");
-
-	m_model->setHorizontalHeaderLabels(labels);
-	m_model->setSortRole(Qt::DisplayRole);
-
-	const QList<QUrl> entries = cache->getEntries();
-
-	for (int i = 0; i < entries.count(); ++i)
-	{
-		addEntry(entries.at(i));
-	}
-
-	m_model->sort(0);
-
-	m_ui->cacheView->setModel(m_model);
-	m_ui->cacheView->setItemDelegate(new ItemDelegate(this));
-	m_ui->cacheView->header()->setTextElideMode(Qt::ElideRight);
-	m_ui->cacheView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
-
-	m_isLoading = false;
+	updateStatistics();
 
 	emit loadingChanged(false);
-
-	connect(cache, SIGNAL(cleared()), this, SLOT(clearEntries()));
-	connect(cache, SIGNAL(entryAdded(QUrl)), this, SLOT(addEntry(QUrl)));
-	connect(cache, SIGNAL(entryRemoved(QUrl)), this, SLOT(removeEntry(QUrl)));
-	connect(m_model, SIGNAL(modelReset()), this, SLOT(updateActions()));
-	connect(m_ui->cacheView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(updateActions()));
 }
 
 void CacheContentsWidget::filterCache(const QString &filter)
 {
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *domainItem = m_model->item(i, 0);
-
-		if (!domainItem)
-		{
-			continue;
-		}
-
-		bool found = (filter.isEmpty() && domainItem->rowCount() > 0);
-
-		for (int j = 0; j < domainItem->rowCount(); ++j)
-		{
-			QStandardItem *entryItem = domainItem->child(j, 0);
-
-			if (!entryItem)
-			{
-				continue;
-			}
-
-			const bool match = (filter.isEmpty() || entryItem->data(Qt::UserRole).toString().contains(filter, Qt::CaseInsensitive) || domainItem->child(j, 1)->text().contains(filter, Qt::CaseInsensitive));
-
-			if (match)
-			{
-				found = true;
-			}
-
-			m_ui->cacheView->setRowHidden(j, domainItem->index(), !match);
-		}
+	m_model->setFilter(filter);
 
-		m_ui->cacheView->setRowHidden(i, m_model->invisibleRootItem()->index(), !found);
-		m_ui->cacheView->setExpanded(domainItem->index(), !filter.isEmpty());
-	}
-}
-
-void CacheContentsWidget::clearEntries()
-{
-	m_model->clear();
-}
-
-void CacheContentsWidget::addEntry(const QUrl &entry)
-{
-	const QString domain = entry.host();
-	QStandardItem *domainItem = findDomain(domain);
-
-	if (domainItem)
+	if (filter.isEmpty())
 	{
-		for (int i = 0; i < domainItem->rowCount(); ++i)
-		{
-			QStandardItem *entryItem = domainItem->child(i, 0);
-
-			if (entry == entryItem->data(Qt::UserRole).toUrl())
-			{
-				return;
-			}
-		}
+		m_ui->cacheView->collapseAll();
 	}
 	else
 	{
-		WebBackend *backend = AddonsManager::getWebBackend();
-
-		domainItem = new QStandardItem(backend->getIconForUrl(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
-		domainItem->setToolTip(domain);
-
-		m_model->appendRow(domainItem);
-		m_model->setItem(domainItem->row(), 2, new QStandardItem(QString()));
-
-		if (sender())
-		{
-			m_model->sort(0);
-		}
-	}
-
-	NetworkCache *cache = NetworkManagerFactory::getCache();
-	QIODevice *device = cache->data(entry);
-	const QNetworkCacheMetaData metaData = cache->metaData(entry);
-	const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
-	QString type;
-
-	for (int i = 0; i < headers.count(); ++i)
-	{
-		if (headers.at(i).first == QStringLiteral("Content-Type").toLatin1())
-		{
-			type = QString(headers.at(i).second);
-
-			break;
-		}
-	}
-
-	const QMimeType mimeType = ((type.isEmpty() && device) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
-	QList<QStandardItem*> entryItems;
-	entryItems.append(new QStandardItem(entry.path()));
-	entryItems.append(new QStandardItem(mimeType.name()));
-	entryItems.append(new QStandardItem(device ? Utils::formatUnit(device->size()) : QString()));
-	entryItems.append(new QStandardItem(metaData.lastModified().toString()));
-	entryItems.append(new QStandardItem(metaData.expirationDate().toString()));
-	entryItems[0]->setData(entry, Qt::UserRole);
-	entryItems[2]->setData((device ? device->size() : 0), Qt::UserRole);
-
-	QStandardItem *sizeItem = m_model->item(domainItem->row(), 2);
-
-	if (sizeItem && device)
-	{
-		sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
-		sizeItem->setText(Utils::formatUnit(sizeItem->data(Qt::UserRole).toLongLong()));
-	}
-
-	if (device)
-	{
-		device->deleteLater();
-	}
-
-	domainItem->appendRow(entryItems);
-	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
-
-	if (sender())
-	{
-		domainItem->sortChildren(0, Qt::DescendingOrder);
-	}
-
-	if (!m_ui->filterLineEdit->text().isEmpty())
-	{
-		filterCache(m_ui->filterLineEdit->text());
-	}
-}
-
-void CacheContentsWidget::removeEntry(const QUrl &entry)
-{
-	QStandardItem *entryItem = findEntry(entry);
-
-	if (entryItem)
-	{
-		QStandardItem *domainItem = entryItem->parent();
-
-		if (domainItem)
-		{
-			QStandardItem *sizeItem = domainItem->child(entryItem->row(), 2);
-			const qint64 size = (sizeItem ? sizeItem->data(Qt::UserRole).toLongLong() : 0);
-
-			m_model->removeRow(entryItem->row(), domainItem->index());
-
-			if (domainItem->rowCount() == 0)
-			{
-				m_model->invisibleRootItem()->removeRow(domainItem->row());
-			}
-			else
-			{
-				QStandardItem *domainSizeItem = m_model->item(domainItem->row(), 2);
-
-				if (domainSizeItem && size > 0)
-				{
-					domainSizeItem->setData((domainSizeItem->data(Qt::UserRole).toLongLong() - size), Qt::UserRole);
-					domainSizeItem->setText(Utils::formatUnit(domainSizeItem->data(Qt::UserRole).toLongLong()));
-				}
-			}
-		}
+		m_ui->cacheView->expandAll();
 	}
 }
 
@@ -307,24 +142,12 @@ void CacheContentsWidget::removeEntry()
 
 void CacheContentsWidget::removeDomainEntries()
 {
-	const QModelIndex index = m_ui->cacheView->currentIndex();
-	QStandardItem *domainItem = ((index.isValid() && index.parent() == m_model->invisibleRootItem()->index()) ? findDomain(index.sibling(index.row(), 0).data(Qt::ToolTipRole).toString()) : findEntry(getEntry(index)));
-
-	if (!domainItem)
-	{
-		return;
-	}
-
+	const QList<QUrl> entries = m_model->getDomainUrls(m_model->getDomain(m_ui->cacheView->currentIndex()));
 	NetworkCache *cache = NetworkManagerFactory::getCache();
 
-	for (int i = (domainItem->rowCount() - 1); i >= 0; --i)
+	for (int i = 0; i < entries.count(); ++i)
 	{
-		QStandardItem *entryItem = domainItem->child(i, 0);
-
-		if (entryItem)
-		{
-			cache->remove(entryItem->data(Qt::UserRole).toUrl());
-		}
+		cache->remove(entries.at(i));
 	}
 }
 
@@ -344,14 +167,7 @@ void CacheContentsWidget::removeDomainEntriesOrEntry()
 
 void CacheContentsWidget::openEntry(const QModelIndex &index)
 {
-	const QModelIndex entryIndex = (index.isValid() ? index : m_ui->cacheView->currentIndex());
-
-	if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
-	{
-		return;
-	}
-
-	const QUrl url = entryIndex.sibling(entryIndex.row(), 0).data(Qt::UserRole).toUrl();
+	const QUrl url = getEntry(index.isValid() ? index : m_ui->cacheView->currentIndex());
 
 	if (url.isValid())
 	{
@@ -363,11 +179,11 @@ void CacheContentsWidget::openEntry(const QModelIndex &index)
 
 void CacheContentsWidget::copyEntryLink()
 {
-	QStandardItem *entryItem = findEntry(getEntry(m_ui->cacheView->currentIndex()));
+	const QUrl entry = getEntry(m_ui->cacheView->currentIndex());
 
-	if (entryItem)
+	if (entry.isValid())
 	{
-		QApplication::clipboard()->setText(entryItem->data(Qt::UserRole).toString());
+		QApplication::clipboard()->setText(entry.toString());
 	}
 }
 
@@ -391,7 +207,7 @@ void CacheContentsWidget::showContextMenu(const QPoint &point)
 		menu.addAction(tr("Remove Entry"), this, SLOT(removeEntry()));
 	}
 
-	if (entry.isValid() || (index.isValid() && index.parent() == m_model->invisibleRootItem()->index()))
+	if (entry.isValid() || (index.isValid() && !index.parent().isValid()))
 	{
 		menu.addAction(tr("Remove All Entries from This Domain"), this, SLOT(removeDomainEntries()));
 		menu.addSeparator();
@@ -405,7 +221,7 @@ void CacheContentsWidget::updateActions()
 {
 	const QModelIndex index = (m_ui->cacheView->selectionModel()->hasSelection() ? m_ui->cacheView->selectionModel()->currentIndex() : QModelIndex());
 	const QUrl entry = getEntry(index);
-	const QString domain = ((index.isValid() && index.parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(Qt::ToolTipRole).toString() : entry.host());
+	const QString domain = m_model->getDomain(index);
 
 	m_ui->locationLabelWidget->setText(QString());
 	m_ui->previewLabel->hide();
@@ -415,20 +231,9 @@ void CacheContentsWidget::updateActions()
 	if (entry.isValid())
 	{
 		NetworkCache *cache = NetworkManagerFactory::getCache();
-		QIODevice *device = cache->data(entry);
-		const QNetworkCacheMetaData metaData = cache->metaData(entry);
-		const QList<QPair<QByteArray, QByteArray> > headers = metaData.rawHeaders();
-		QString type;
-
-		for (int i = 0; i < headers.count(); ++i)
-		{
-			if (headers.at(i).first == QStringLiteral("Content-Type").toLatin1())
-			{
-				type = QString(headers.at(i).second);
-
-				break;
-			}
-		}
+		QIODevice *device = cache->getEntryData(entry);
+		const NetworkCacheIndex::Entry cacheEntry = cache->getEntry(entry);
+		const QString type = cacheEntry.type.section(QLatin1Char(';'), 0, 0).trimmed();
 
 		const QMimeType mimeType = ((type.isEmpty() && device) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
 		QPixmap preview;
@@ -456,8 +261,8 @@ void CacheContentsWidget::updateActions()
 		m_ui->locationLabelWidget->setText(cache->getPathForUrl(entry));
 		m_ui->typeLabelWidget->setText(mimeType.name());
 		m_ui->sizeLabelWidget->setText(device ? Utils::formatUnit(device->size(), false, 2) : tr("Unknown"));
-		m_ui->lastModifiedLabelWidget->setText(metaData.lastModified().toString());
-		m_ui->expiresLabelWidget->setText(metaData.expirationDate().toString());
+		m_ui->lastModifiedLabelWidget->setText(cacheEntry.lastModified.toString());
+		m_ui->expiresLabelWidget->setText(cacheEntry.expirationDate.toString());
 
 		if (!preview.isNull())
 		{
@@ -465,45 +270,8 @@ void CacheContentsWidget::updateActions()
 			m_ui->previewLabel->setPixmap(preview);
 		}
 
-		QStandardItem *typeItem = m_model->itemFromIndex(index.sibling(index.row(), 1));
-
-		if (typeItem && typeItem->text().isEmpty())
-		{
-			typeItem->setText(mimeType.name());
-		}
-
-		QStandardItem *lastModifiedItem = m_model->itemFromIndex(index.sibling(index.row(), 3));
-
-		if (lastModifiedItem && lastModifiedItem->text().isEmpty())
-		{
-			lastModifiedItem->setText(metaData.lastModified().toString());
-		}
-
-		QStandardItem *expiresItem = m_model->itemFromIndex(index.sibling(index.row(), 4));
-
-		if (expiresItem && expiresItem->text().isEmpty())
-		{
-			expiresItem->setText(metaData.expirationDate().toString());
-		}
-
 		if (device)
 		{
-			QStandardItem *sizeItem = m_model->itemFromIndex(index.sibling(index.row(), 2));
-
-			if (sizeItem && sizeItem->text().isEmpty())
-			{
-				sizeItem->setText(Utils::formatUnit(device->size()));
-				sizeItem->setData(device->size(), Qt::UserRole);
-
-				QStandardItem *domainSizeItem = (sizeItem->parent() ? m_model->item(sizeItem->parent()->row(), 2) : NULL);
-
-				if (domainSizeItem)
-				{
-					domainSizeItem->setData((domainSizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
-					domainSizeItem->setText(Utils::formatUnit(domainSizeItem->data(Qt::UserRole).toLongLong()));
-				}
-			}
-
 			device->deleteLater();
 		}
 	}
@@ -527,40 +295,16 @@ void CacheContentsWidget::updateActions()
 	}
 }
 
-QStandardItem* CacheContentsWidget::findDomain(const QString &domain)
+void CacheContentsWidget::updateStatistics()
 {
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		if (domain == m_model->item(i, 0)->toolTip())
-		{
-			return m_model->item(i, 0);
-		}
-	}
-
-	return NULL;
-}
-
-QStandardItem* CacheContentsWidget::findEntry(const QUrl &entry)
-{
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *domainItem = m_model->item(i, 0);
-
-		if (domainItem)
-		{
-			for (int j = 0; j < domainItem->rowCount(); ++j)
-			{
-				QStandardItem *entryItem = domainItem->child(j, 0);
-
-				if (entryItem && entry == entryItem->data(Qt::UserRole).toUrl())
-				{
-					return entryItem;
-				}
-			}
-		}
-	}
+	NetworkCache *cache = NetworkManagerFactory::getCache();
+	const qint64 memoryHits = cache->getMemoryHitsAmount();
+	const qint64 diskHits = cache->getDiskHitsAmount();
+	const qint64 requests = (memoryHits + diskHits + cache->getMissesAmount());
+	const qreal memoryHitRatio = ((requests > 0) ? ((memoryHits * 100.0) / requests) : 0);
+	const qreal diskHitRatio = (((requests - memoryHits) > 0) ? ((diskHits * 100.0) / (requests - memoryHits)) : 0);
 
-	return NULL;
+	m_ui->statisticsLabel->setText(tr("Memory cache hit ratio: %1%, disk cache hit ratio: %2% (%3 requests), deduplication ratio: %4").arg(QString::number(memoryHitRatio, 'f', 1)).arg(QString::number(diskHitRatio, 'f', 1)).arg(requests).arg(QString::number(cache->getDeduplicationRatio(), 'f', 2)));
 }
 
 Action* CacheContentsWidget::getAction(int identifier)
@@ -606,12 +350,12 @@ QIcon CacheContentsWidget::getIcon() const
 
 QUrl CacheContentsWidget::getEntry(const QModelIndex &index) const
 {
-	return ((index.isValid() && index.parent().isValid() && index.parent().parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(Qt::UserRole).toUrl() : QUrl());
+	return m_model->getUrl(index);
 }
 
 bool CacheContentsWidget::isLoading() const
 {
-	return m_isLoading;
+	return m_model->isLoading();
 }
 
 bool CacheContentsWidget::eventFilter(QObject *object, QEvent *event)
@@ -622,14 +366,7 @@ bool CacheContentsWidget::eventFilter(QObject *object, QEvent *event)
 
 		if (mouseEvent && ((mouseEvent->button() == Qt::LeftButton && mouseEvent->modifiers() != Qt::NoModifier) || mouseEvent->button() == Qt::MiddleButton))
 		{
-			const QModelIndex entryIndex = m_ui->cacheView->currentIndex();
-
-			if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
-			{
-				return ContentsWidget::eventFilter(object, event);
-			}
-
-			const QUrl url = entryIndex.sibling(entryIndex.row(), 0).data(Qt::UserRole).toUrl();
+			const QUrl url = getEntry(m_ui->cacheView->currentIndex());
 
 			if (url.isValid())
 			{
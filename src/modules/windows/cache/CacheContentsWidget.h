@@ -22,8 +22,6 @@
 
 #include "../../../ui/ContentsWidget.h"
 
-#include <QtGui/QStandardItemModel>
-
 namespace Otter
 {
 
@@ -32,6 +30,7 @@ namespace Ui
 	class CacheContentsWidget;
 }
 
+class NetworkCacheModel;
 class Window;
 
 class CacheContentsWidget : public ContentsWidget
@@ -56,17 +55,11 @@ public slots:
 
 protected:
 	void changeEvent(QEvent *event);
-	QStandardItem* findDomain(const QString &domain);
-	QStandardItem* findEntry(const QUrl &entry);
 	QUrl getEntry(const QModelIndex &index) const;
 
 protected slots:
 	void triggerAction();
-	void populateCache();
 	void filterCache(const QString &filter);
-	void clearEntries();
-	void addEntry(const QUrl &entry);
-	void removeEntry(const QUrl &entry);
 	void removeEntry();
 	void removeDomainEntries();
 	void removeDomainEntriesOrEntry();
@@ -74,11 +67,12 @@ protected slots:
 	void copyEntryLink();
 	void showContextMenu(const QPoint &point);
 	void updateActions();
+	void updateLoading();
+	void updateStatistics();
 
 private:
-	QStandardItemModel *m_model;
+	NetworkCacheModel *m_model;
 	QHash<int, Action*> m_actions;
-	bool m_isLoading;
 	Ui::CacheContentsWidget *m_ui;
 };
 
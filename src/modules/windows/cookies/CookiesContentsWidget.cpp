@@ -19,11 +19,10 @@
 
 #include "CookiesContentsWidget.h"
 #include "../../../core/ActionsManager.h"
-#include "../../../core/AddonsManager.h"
+#include "../../../core/FaviconsCache.h"
 #include "../../../core/CookieJar.h"
 #include "../../../core/NetworkManagerFactory.h"
 #include "../../../core/Utils.h"
-#include "../../../core/WebBackend.h"
 
 #include "ui_CookiesContentsWidget.h"
 
@@ -89,6 +88,7 @@ void CookiesContentsWidget::populateCookies()
 	connect(cookieJar, SIGNAL(cookieAdded(QNetworkCookie)), this, SLOT(addCookie(QNetworkCookie)));
 	connect(cookieJar, SIGNAL(cookieRemoved(QNetworkCookie)), this, SLOT(removeCookie(QNetworkCookie)));
 	connect(m_model, SIGNAL(modelReset()), this, SLOT(updateActions()));
+	connect(FaviconsCache::getInstance(), SIGNAL(iconsChanged(QStringList)), this, SLOT(updateIcons(QStringList)));
 	connect(m_ui->cookiesView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(updateActions()));
 }
 
@@ -109,9 +109,7 @@ void CookiesContentsWidget::addCookie(const QNetworkCookie &cookie)
 	}
 	else
 	{
-		WebBackend *backend = AddonsManager::getWebBackend();
-
-		domainItem = new QStandardItem(backend->getIconForUrl(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
+		domainItem = new QStandardItem(FaviconsCache::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
 		domainItem->setToolTip(domain);
 
 		m_model->appendRow(domainItem);
@@ -362,6 +360,20 @@ void CookiesContentsWidget::filterCookies(const QString &filter)
 	}
 }
 
+void CookiesContentsWidget::updateIcons(const QStringList &keys)
+{
+	for (int i = 0; i < m_model->rowCount(); ++i)
+	{
+		QStandardItem *domainItem = m_model->item(i, 0);
+		const QUrl url(QStringLiteral("http://%1/").arg(domainItem->toolTip()));
+
+		if (keys.contains(FaviconsCache::getKey(url)))
+		{
+			domainItem->setIcon(FaviconsCache::getIcon(url));
+		}
+	}
+}
+
 QStandardItem* CookiesContentsWidget::findDomain(const QString &domain)
 {
 	for (int i = 0; i < m_model->rowCount(); ++i)
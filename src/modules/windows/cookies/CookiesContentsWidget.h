@@ -69,6 +69,7 @@ protected slots:
 	void removeDomainCookies();
 	void showContextMenu(const QPoint &point);
 	void updateActions();
+	void updateIcons(const QStringList &keys);
 
 private:
 	QStandardItemModel *m_model;
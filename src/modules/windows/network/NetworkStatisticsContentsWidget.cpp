@@ -0,0 +1,199 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkStatisticsContentsWidget.h"
+#include "../../../core/FaviconsCache.h"
+#include "../../../core/NetworkCache.h"
+#include "../../../core/NetworkManager.h"
+#include "../../../core/NetworkManagerFactory.h"
+#include "../../../core/Utils.h"
+
+#include "ui_NetworkStatisticsContentsWidget.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+NetworkStatisticsContentsWidget::NetworkStatisticsContentsWidget(Window *window) : ContentsWidget(window),
+	m_model(new QStandardItemModel(this)),
+	m_updateTimer(0),
+	m_ui(new Ui::NetworkStatisticsContentsWidget)
+{
+	m_ui->setupUi(this);
+
+	QStringList labels;
+	labels << tr("Host") << tr("Entries") << tr("Size") << tr("Average Age") << tr("Hits") << tr("Misses") << tr("Hit Ratio") << tr("Evictions") << tr("From Cache") << tr("From Network");
+
+	m_model->setHorizontalHeaderLabels(labels);
+	m_model->setSortRole(Qt::UserRole);
+
+	m_ui->statisticsView->setModel(m_model);
+	m_ui->statisticsView->setSortingEnabled(true);
+	m_ui->statisticsView->sortByColumn(2, Qt::DescendingOrder);
+	m_ui->statisticsView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	updateStatistics();
+
+	m_updateTimer = startTimer(2000);
+
+	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterStatistics(QString)));
+}
+
+NetworkStatisticsContentsWidget::~NetworkStatisticsContentsWidget()
+{
+	delete m_ui;
+}
+
+void NetworkStatisticsContentsWidget::changeEvent(QEvent *event)
+{
+	QWidget::changeEvent(event);
+
+	switch (event->type())
+	{
+		case QEvent::LanguageChange:
+			m_ui->retranslateUi(this);
+
+			break;
+		default:
+			break;
+	}
+}
+
+void NetworkStatisticsContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer && isVisible())
+	{
+		updateStatistics();
+	}
+}
+
+void NetworkStatisticsContentsWidget::print(QPrinter *printer)
+{
+	m_ui->statisticsView->render(printer);
+}
+
+void NetworkStatisticsContentsWidget::filterStatistics(const QString &filter)
+{
+	for (int i = 0; i < m_model->rowCount(); ++i)
+	{
+		m_ui->statisticsView->setRowHidden(i, QModelIndex(), (!filter.isEmpty() && !m_model->item(i, 0)->text().contains(filter, Qt::CaseInsensitive)));
+	}
+}
+
+void NetworkStatisticsContentsWidget::updateStatistics()
+{
+	const QHash<QString, NetworkCache::HostStatistics> cacheStatistics = NetworkManagerFactory::getCache()->getHostStatistics();
+	const QHash<QString, NetworkManager::HostStatistics> networkStatistics = NetworkManager::getHostStatistics();
+	QSet<QString> hosts = cacheStatistics.keys().toSet();
+	hosts.unite(networkStatistics.keys().toSet());
+
+	qint64 cacheBytes = 0;
+	qint64 networkBytes = 0;
+	qint64 evictions = 0;
+	QSet<QString>::const_iterator iterator;
+
+	for (iterator = hosts.constBegin(); iterator != hosts.constEnd(); ++iterator)
+	{
+		const QString host = *iterator;
+		const NetworkCache::HostStatistics cacheHostStatistics = cacheStatistics.value(host);
+		const NetworkManager::HostStatistics networkHostStatistics = networkStatistics.value(host);
+		const qint64 lookups = (cacheHostStatistics.hits + cacheHostStatistics.misses);
+		const qreal hitRatio = ((lookups > 0) ? ((cacheHostStatistics.hits * 100.0) / lookups) : 0);
+
+		if (!m_hosts.contains(host))
+		{
+			QList<QStandardItem*> items;
+			items.append(new QStandardItem(FaviconsCache::getIcon(QUrl(QStringLiteral("http://%1/").arg(host))), host));
+			items[0]->setData(host, Qt::UserRole);
+			items[0]->setToolTip(host);
+
+			for (int i = 1; i < m_model->columnCount(); ++i)
+			{
+				items.append(new QStandardItem());
+			}
+
+			m_model->appendRow(items);
+
+			m_hosts[host] = items;
+		}
+
+		const QList<QStandardItem*> items = m_hosts[host];
+
+		setValue(items.at(1), cacheHostStatistics.entries, QString::number(cacheHostStatistics.entries));
+		setValue(items.at(2), cacheHostStatistics.size, Utils::formatUnit(cacheHostStatistics.size));
+		setValue(items.at(3), cacheHostStatistics.averageAge, ((cacheHostStatistics.entries > 0) ? tr("%n hour(s)", "", (int) (cacheHostStatistics.averageAge / 3600)) : QString()));
+		setValue(items.at(4), cacheHostStatistics.hits, QString::number(cacheHostStatistics.hits));
+		setValue(items.at(5), cacheHostStatistics.misses, QString::number(cacheHostStatistics.misses));
+		setValue(items.at(6), hitRatio, ((lookups > 0) ? QStringLiteral("%1%").arg(QString::number(hitRatio, 'f', 1)) : QString()));
+		setValue(items.at(7), cacheHostStatistics.evictions, QString::number(cacheHostStatistics.evictions));
+		setValue(items.at(8), networkHostStatistics.cacheBytes, Utils::formatUnit(networkHostStatistics.cacheBytes));
+		setValue(items.at(9), networkHostStatistics.networkBytes, Utils::formatUnit(networkHostStatistics.networkBytes));
+
+		cacheBytes += networkHostStatistics.cacheBytes;
+		networkBytes += networkHostStatistics.networkBytes;
+		evictions += cacheHostStatistics.evictions;
+	}
+
+	const QStringList removedHosts = (m_hosts.keys().toSet() - hosts).toList();
+
+	for (int i = 0; i < removedHosts.count(); ++i)
+	{
+		m_model->removeRow(m_hosts.take(removedHosts.at(i)).at(0)->row());
+	}
+
+	m_ui->statisticsView->sortByColumn(m_ui->statisticsView->header()->sortIndicatorSection(), m_ui->statisticsView->header()->sortIndicatorOrder());
+
+	filterStatistics(m_ui->filterLineEdit->text());
+
+	m_ui->summaryLabel->setText(tr("Hosts: %1, served from cache: %2, received from network: %3, evictions: %4").arg(hosts.count()).arg(Utils::formatUnit(cacheBytes)).arg(Utils::formatUnit(networkBytes)).arg(evictions));
+}
+
+void NetworkStatisticsContentsWidget::setValue(QStandardItem *item, const QVariant &value, const QString &text)
+{
+	if (item->text() != text)
+	{
+		item->setText(text);
+	}
+
+	item->setData(value, Qt::UserRole);
+}
+
+QString NetworkStatisticsContentsWidget::getTitle() const
+{
+	return tr("Network Statistics");
+}
+
+QLatin1String NetworkStatisticsContentsWidget::getType() const
+{
+	return QLatin1String("network");
+}
+
+QUrl NetworkStatisticsContentsWidget::getUrl() const
+{
+	return QUrl(QLatin1String("about:network"));
+}
+
+QIcon NetworkStatisticsContentsWidget::getIcon() const
+{
+	return Utils::getIcon(QLatin1String("cache"), false);
+}
+
+}
@@ -0,0 +1,69 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKSTATISTICSCONTENTSWIDGET_H
+#define OTTER_NETWORKSTATISTICSCONTENTSWIDGET_H
+
+#include "../../../ui/ContentsWidget.h"
+
+#include <QtGui/QStandardItemModel>
+
+namespace Otter
+{
+
+namespace Ui
+{
+	class NetworkStatisticsContentsWidget;
+}
+
+class Window;
+
+class NetworkStatisticsContentsWidget : public ContentsWidget
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkStatisticsContentsWidget(Window *window);
+	~NetworkStatisticsContentsWidget();
+
+	void print(QPrinter *printer);
+	QString getTitle() const;
+	QLatin1String getType() const;
+	QUrl getUrl() const;
+	QIcon getIcon() const;
+
+protected:
+	void changeEvent(QEvent *event);
+	void timerEvent(QTimerEvent *event);
+	void setValue(QStandardItem *item, const QVariant &value, const QString &text);
+
+protected slots:
+	void filterStatistics(const QString &filter);
+	void updateStatistics();
+
+private:
+	QStandardItemModel *m_model;
+	QHash<QString, QList<QStandardItem*> > m_hosts;
+	int m_updateTimer;
+	Ui::NetworkStatisticsContentsWidget *m_ui;
+};
+
+}
+
+#endif
@@ -47,6 +47,7 @@ AddressWidget::AddressWidget(Window *window, bool simpleMode, QWidget *parent) :
 	m_bookmarkLabel(NULL),
 	m_loadPluginsLabel(NULL),
 	m_urlIconLabel(NULL),
+	m_isDeletingText(false),
 	m_simpleMode(simpleMode)
 {
 	m_completer->setCaseSensitivity(Qt::CaseInsensitive);
@@ -68,7 +69,8 @@ AddressWidget::AddressWidget(Window *window, bool simpleMode, QWidget *parent) :
 		connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 	}
 
-	connect(this, SIGNAL(textChanged(QString)), this, SLOT(setCompletion(QString)));
+	connect(this, SIGNAL(textEdited(QString)), this, SLOT(setCompletion(QString)));
+	connect(AddressCompletionModel::getInstance(), SIGNAL(completionReady(QString,bool)), this, SLOT(updateCompletion(QString)));
 	connect(BookmarksManager::getInstance(), SIGNAL(modelModified()), this, SLOT(updateBookmark()));
 }
 
@@ -137,6 +139,8 @@ void AddressWidget::focusInEvent(QFocusEvent *event)
 
 void AddressWidget::keyPressEvent(QKeyEvent *event)
 {
+	m_isDeletingText = (event->key() == Qt::Key_Backspace || event->key() == Qt::Key_Delete);
+
 	QLineEdit::keyPressEvent(event);
 
 	if (m_window && event->key() == Qt::Key_Escape)
@@ -430,9 +434,37 @@ void AddressWidget::updateIcons()
 
 void AddressWidget::setCompletion(const QString &text)
 {
+	AddressCompletionModel::getInstance()->setFilter(text);
+
 	m_completer->setCompletionPrefix(text);
 }
 
+void AddressWidget::updateCompletion(const QString &filter)
+{
+	if (!hasFocus() || m_isDeletingText || filter.isEmpty())
+	{
+		return;
+	}
+
+	const bool hasCompletion = (hasSelectedText() && (selectionStart() + selectedText().length()) == text().length());
+	const QString typedText = (hasCompletion ? text().left(selectionStart()) : text());
+
+	if (typedText != filter || (!hasCompletion && cursorPosition() != text().length()))
+	{
+		return;
+	}
+
+	m_completer->setCompletionPrefix(filter);
+
+	const QString completion = m_completer->currentCompletion();
+
+	if (completion.length() > filter.length() && completion.startsWith(filter, Qt::CaseInsensitive))
+	{
+		setText(filter + completion.mid(filter.length()));
+		setSelection(filter.length(), (completion.length() - filter.length()));
+	}
+}
+
 void AddressWidget::setIcon(const QIcon &icon)
 {
 	if (m_urlIconLabel)
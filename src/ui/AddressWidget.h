@@ -64,6 +64,7 @@ protected slots:
 	void updateLoadPlugins();
 	void updateIcons();
 	void setCompletion(const QString &text);
+	void updateCompletion(const QString &filter);
 	void setIcon(const QIcon &icon);
 
 private:
@@ -74,6 +75,7 @@ private:
 	QLabel *m_urlIconLabel;
 	QRect m_securityBadgeRectangle;
 	OpenHints m_hints;
+	bool m_isDeletingText;
 	bool m_simpleMode;
 
 signals:
@@ -24,6 +24,7 @@
 #include "../core/AddonsManager.h"
 #include "../core/BookmarksManager.h"
 #include "../core/BookmarksModel.h"
+#include "../core/FaviconsCache.h"
 #include "../core/NetworkManagerFactory.h"
 #include "../core/SessionsManager.h"
 #include "../core/Utils.h"
@@ -33,6 +34,8 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QTextCodec>
 #include <QtGui/QMouseEvent>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QDesktopWidget>
 
 namespace Otter
 {
@@ -40,10 +43,43 @@ namespace Otter
 Menu::Menu(QWidget *parent) : QMenu(parent),
 	m_actionGroup(NULL),
 	m_bookmark(NULL),
-	m_role(NoMenuRole)
+	m_role(NoMenuRole),
+	m_bookmarksOffset(0),
+	m_iconsOffset(0),
+	m_populateTimer(0)
 {
 }
 
+void Menu::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_populateTimer)
+	{
+		if (!m_bookmarksBranch.isValid())
+		{
+			killTimer(m_populateTimer);
+
+			m_populateTimer = 0;
+		}
+		else
+		{
+			if (m_bookmarksOffset >= 0)
+			{
+				appendBookmarks(100);
+			}
+
+			updateBookmarkIcons(50);
+
+			if (m_bookmarksOffset < 0 && m_iconsOffset < 0)
+			{
+				killTimer(m_populateTimer);
+
+				m_populateTimer = 0;
+				m_bookmarksBranch = QPersistentModelIndex();
+			}
+		}
+	}
+}
+
 void Menu::changeEvent(QEvent *event)
 {
 	QMenu::changeEvent(event);
@@ -201,6 +237,11 @@ void Menu::setRole(MenuRole role)
 
 			connect(this, SIGNAL(aboutToShow()), this, SLOT(populateBookmarksMenu()));
 
+			if (FaviconsCache::getInstance())
+			{
+				connect(FaviconsCache::getInstance(), SIGNAL(iconsChanged(QStringList)), this, SLOT(updateBookmarkIcons(QStringList)));
+			}
+
 			break;
 
 		case CharacterEncodingMenuRole:
@@ -280,7 +321,32 @@ void Menu::populateBookmarksMenu()
 		menu->addSeparator();
 	}
 
-	for (int i = 0; i < branch->rowCount(); ++i)
+	m_bookmarksBranch = branch->index();
+	m_bookmarksOffset = 0;
+	m_iconsOffset = actions().count();
+
+	appendBookmarks(QApplication::desktop()->availableGeometry(this).height() / qMax(1, fontMetrics().height()));
+
+	if (m_populateTimer == 0)
+	{
+		m_populateTimer = startTimer(0);
+	}
+}
+
+void Menu::appendBookmarks(int amount)
+{
+	QStandardItem *branch = BookmarksManager::getModel()->itemFromIndex(m_bookmarksBranch);
+
+	if (!branch)
+	{
+		m_bookmarksOffset = -1;
+
+		return;
+	}
+
+	const int limit = qMin(branch->rowCount(), (m_bookmarksOffset + amount));
+
+	for (int i = m_bookmarksOffset; i < limit; ++i)
 	{
 		QStandardItem *item = branch->child(i);
 
@@ -293,7 +359,7 @@ void Menu::populateBookmarksMenu()
 
 		if (type == BookmarksItem::RootBookmark || type == BookmarksItem::FolderBookmark || type == BookmarksItem::UrlBookmark)
 		{
-			QAction *action = menu->addAction(item->data(Qt::DecorationRole).value<QIcon>(), (item->data(BookmarksModel::TitleRole).toString().isEmpty() ? tr("(Untitled)") : Utils::elideText(QString(item->data(BookmarksModel::TitleRole).toString()).replace(QLatin1Char('&'), QLatin1String("&&")), menu)));
+			QAction *action = QMenu::addAction((type == BookmarksItem::UrlBookmark) ? QIcon() : item->data(Qt::DecorationRole).value<QIcon>(), (item->data(BookmarksModel::TitleRole).toString().isEmpty() ? tr("(Untitled)") : Utils::elideText(QString(item->data(BookmarksModel::TitleRole).toString()).replace(QLatin1Char('&'), QLatin1String("&&")), this)));
 			action->setData(item->index());
 			action->setToolTip(item->data(BookmarksModel::DescriptionRole).toString());
 
@@ -311,7 +377,60 @@ void Menu::populateBookmarksMenu()
 		}
 		else
 		{
-			menu->addSeparator();
+			addSeparator();
+		}
+	}
+
+	m_bookmarksOffset = ((limit < branch->rowCount()) ? limit : -1);
+}
+
+void Menu::updateBookmarkIcons(int amount)
+{
+	const QList<QAction*> actions = this->actions();
+	const int limit = qMin(actions.count(), (m_iconsOffset + amount));
+
+	for (int i = m_iconsOffset; i < limit; ++i)
+	{
+		QAction *action = actions.at(i);
+
+		if (action->data().type() == QVariant::ModelIndex && action->icon().isNull())
+		{
+			QStandardItem *item = BookmarksManager::getModel()->itemFromIndex(action->data().toModelIndex());
+
+			if (item)
+			{
+				action->setIcon(item->data(Qt::DecorationRole).value<QIcon>());
+
+				if (static_cast<BookmarksItem::BookmarkType>(item->data(BookmarksModel::TypeRole).toInt()) == BookmarksItem::UrlBookmark)
+				{
+					m_iconActions[FaviconsCache::getKey(item->data(BookmarksModel::UrlRole).toUrl())].append(action);
+				}
+			}
+		}
+	}
+
+	m_iconsOffset = ((limit < actions.count() || m_bookmarksOffset >= 0) ? limit : -1);
+}
+
+void Menu::updateBookmarkIcons(const QStringList &keys)
+{
+	if (m_iconActions.isEmpty())
+	{
+		return;
+	}
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const QList<QAction*> actions = m_iconActions.value(keys.at(i));
+
+		for (int j = 0; j < actions.count(); ++j)
+		{
+			QStandardItem *item = BookmarksManager::getModel()->itemFromIndex(actions.at(j)->data().toModelIndex());
+
+			if (item)
+			{
+				actions.at(j)->setIcon(item->data(Qt::DecorationRole).value<QIcon>());
+			}
 		}
 	}
 }
@@ -508,6 +627,16 @@ void Menu::populateUserAgentMenu()
 
 void Menu::clearBookmarksMenu()
 {
+	if (m_populateTimer != 0)
+	{
+		killTimer(m_populateTimer);
+
+		m_populateTimer = 0;
+	}
+
+	m_bookmarksBranch = QPersistentModelIndex();
+	m_iconActions.clear();
+
 	if (actions().count() > 3)
 	{
 		for (int i = (actions().count() - 1); i > 2; --i)
@@ -21,6 +21,7 @@
 #define OTTER_MENU_H
 
 #include <QtCore/QJsonObject>
+#include <QtCore/QPersistentModelIndex>
 #include <QtWidgets/QMenu>
 
 namespace Otter
@@ -52,9 +53,12 @@ public:
 	Action* addAction(int identifier);
 
 protected:
+	void timerEvent(QTimerEvent *event);
 	void changeEvent(QEvent *event);
 	void mouseReleaseEvent(QMouseEvent *event);
 	void contextMenuEvent(QContextMenuEvent *event);
+	void appendBookmarks(int amount);
+	void updateBookmarkIcons(int amount);
 
 protected slots:
 	void populateBookmarksMenu();
@@ -70,13 +74,19 @@ protected slots:
 	void openSession(QAction *action);
 	void selectCharacterEncoding(QAction *action);
 	void selectUserAgent(QAction *action);
+	void updateBookmarkIcons(const QStringList &keys);
 	void updateClosedWindowsMenu();
 
 private:
 	QActionGroup *m_actionGroup;
 	BookmarksItem *m_bookmark;
+	QPersistentModelIndex m_bookmarksBranch;
+	QHash<QString, QList<QAction*> > m_iconActions;
 	QString m_title;
 	MenuRole m_role;
+	int m_bookmarksOffset;
+	int m_iconsOffset;
+	int m_populateTimer;
 };
 
 }
@@ -0,0 +1,69 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "WaterfallDelegate.h"
+
+#include <QtGui/QPainter>
+
+namespace Otter
+{
+
+WaterfallDelegate::WaterfallDelegate(QObject *parent) : QItemDelegate(parent),
+	m_duration(0)
+{
+}
+
+void WaterfallDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	drawBackground(painter, option, index);
+
+	if (m_duration <= 0)
+	{
+		return;
+	}
+
+	const QRect rectangle = option.rect.marginsRemoved(QMargins(2, 3, 2, 3));
+	const qreal scale = (rectangle.width() / (qreal) m_duration);
+	const qint64 queuedTime = index.data(QueuedTimeRole).toLongLong();
+	const qint64 startTime = qMax(queuedTime, index.data(StartTimeRole).toLongLong());
+	const qint64 firstByteTime = qMax(startTime, index.data(FirstByteTimeRole).toLongLong());
+	const qint64 finishTime = qMax(firstByteTime, index.data(FinishTimeRole).toLongLong());
+
+	painter->save();
+
+	if (index.data(IsBlockedRole).toBool())
+	{
+		painter->fillRect(QRectF((rectangle.left() + (queuedTime * scale)), rectangle.top(), 2, rectangle.height()), QColor(204, 0, 0));
+		painter->restore();
+
+		return;
+	}
+
+	painter->fillRect(QRectF((rectangle.left() + (queuedTime * scale)), rectangle.top(), qMax(1.0, ((startTime - queuedTime) * scale)), rectangle.height()), QColor(192, 192, 192));
+	painter->fillRect(QRectF((rectangle.left() + (startTime * scale)), rectangle.top(), ((firstByteTime - startTime) * scale), rectangle.height()), QColor(237, 180, 60));
+	painter->fillRect(QRectF((rectangle.left() + (firstByteTime * scale)), rectangle.top(), qMax(1.0, ((finishTime - firstByteTime) * scale)), rectangle.height()), (index.data(IsFromCacheRole).toBool() ? QColor(78, 154, 6) : QColor(52, 101, 164)));
+	painter->restore();
+}
+
+void WaterfallDelegate::setDuration(qint64 duration)
+{
+	m_duration = duration;
+}
+
+}
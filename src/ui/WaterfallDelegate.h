@@ -0,0 +1,52 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_WATERFALLDELEGATE_H
+#define OTTER_WATERFALLDELEGATE_H
+
+#include <QtWidgets/QItemDelegate>
+
+namespace Otter
+{
+
+class WaterfallDelegate : public QItemDelegate
+{
+public:
+	enum DataRole
+	{
+		QueuedTimeRole = Qt::UserRole,
+		StartTimeRole = (Qt::UserRole + 1),
+		FirstByteTimeRole = (Qt::UserRole + 2),
+		FinishTimeRole = (Qt::UserRole + 3),
+		IsFromCacheRole = (Qt::UserRole + 4),
+		IsBlockedRole = (Qt::UserRole + 5)
+	};
+
+	explicit WaterfallDelegate(QObject *parent = NULL);
+
+	void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+	void setDuration(qint64 duration);
+
+private:
+	qint64 m_duration;
+};
+
+}
+
+#endif
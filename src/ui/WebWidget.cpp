@@ -330,6 +330,7 @@ void WebWidget::showContextMenu(const QPoint &position, MenuFlags flags)
 
 		menu.addAction(ActionsManager::getAction(Action::ContentBlockingAction, this));
 		menu.addAction(getAction(Action::WebsitePreferencesAction));
+		menu.addAction(getAction(Action::WebsiteInformationAction));
 		menu.addSeparator();
 		menu.addAction(ActionsManager::getAction(Action::FullScreenAction, this));
 	}
@@ -21,6 +21,7 @@
 #ifndef OTTER_WEBWIDGET_H
 #define OTTER_WEBWIDGET_H
 
+#include "../core/HttpArchive.h"
 #include "../core/SessionsManager.h"
 #include "Window.h"
 
@@ -113,6 +114,7 @@ public:
 	QVariantHash getOptions() const;
 	virtual QHash<QByteArray, QByteArray> getHeaders() const = 0;
 	virtual QVariantHash getStatistics() const = 0;
+	virtual QList<HttpArchive::Entry> getTimeline() const = 0;
 	ScrollMode getScrollMode() const;
 	virtual int getZoom() const = 0;
 	bool hasOption(const QString &key) const;
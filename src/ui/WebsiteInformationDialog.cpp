@@ -0,0 +1,170 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2015 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "WebsiteInformationDialog.h"
+#include "WaterfallDelegate.h"
+#include "WebWidget.h"
+#include "../core/NetworkCache.h"
+#include "../core/NetworkManagerFactory.h"
+#include "../core/TransfersManager.h"
+#include "../core/Utils.h"
+
+#include "ui_WebsiteInformationDialog.h"
+
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QMessageBox>
+#include <QtWidgets/QPushButton>
+
+namespace Otter
+{
+
+WebsiteInformationDialog::WebsiteInformationDialog(WebWidget *widget, QWidget *parent) : QDialog(parent),
+	m_model(new QStandardItemModel(this)),
+	m_title(widget->getTitle()),
+	m_url(widget->getUrl()),
+	m_timeline(widget->getTimeline()),
+	m_ui(new Ui::WebsiteInformationDialog)
+{
+	m_ui->setupUi(this);
+
+	WaterfallDelegate *delegate = new WaterfallDelegate(this);
+	qint64 duration = 0;
+	qint64 bytesReceived = 0;
+	int cachedRequests = 0;
+	int blockedRequests = 0;
+
+	m_model->setHorizontalHeaderLabels(QStringList() << tr("Address") << tr("Method") << tr("Status") << tr("Type") << tr("Size") << tr("Time") << tr("Timeline"));
+
+	for (int i = 0; i < m_timeline.count(); ++i)
+	{
+		const HttpArchive::Entry &entry = m_timeline.at(i);
+		const qint64 finishTime = qMax(entry.queuedTime, entry.finishTime);
+		QString status;
+
+		if (entry.isBlocked)
+		{
+			status = tr("Blocked");
+
+			++blockedRequests;
+		}
+		else if (entry.finishTime < 0)
+		{
+			status = tr("Pending");
+		}
+		else
+		{
+			status = ((entry.status > 0) ? QString::number(entry.status) : QString());
+
+			if (entry.isFromCache)
+			{
+				status = (status.isEmpty() ? tr("Cache") : tr("%1 (cache)").arg(status));
+
+				++cachedRequests;
+			}
+		}
+
+		QStandardItem *timelineItem = new QStandardItem();
+		timelineItem->setData(entry.queuedTime, WaterfallDelegate::QueuedTimeRole);
+		timelineItem->setData(((entry.startTime < 0) ? entry.queuedTime : entry.startTime), WaterfallDelegate::StartTimeRole);
+		timelineItem->setData(entry.firstByteTime, WaterfallDelegate::FirstByteTimeRole);
+		timelineItem->setData(finishTime, WaterfallDelegate::FinishTimeRole);
+		timelineItem->setData(entry.isFromCache, WaterfallDelegate::IsFromCacheRole);
+		timelineItem->setData(entry.isBlocked, WaterfallDelegate::IsBlockedRole);
+
+		QList<QStandardItem*> items;
+		items.append(new QStandardItem(entry.url.toDisplayString()));
+		items.append(new QStandardItem(QString::fromLatin1(entry.method)));
+		items.append(new QStandardItem(status));
+		items.append(new QStandardItem(entry.mimeType.section(QLatin1Char(';'), 0, 0)));
+		items.append(new QStandardItem((entry.bytesReceived > 0) ? Utils::formatUnit(entry.bytesReceived, false, 1) : QString()));
+		items.append(new QStandardItem((entry.finishTime < 0) ? QString() : tr("%1 ms").arg(finishTime - entry.queuedTime)));
+		items.append(timelineItem);
+		items[0]->setToolTip(entry.url.toDisplayString());
+
+		m_model->appendRow(items);
+
+		duration = qMax(duration, finishTime);
+		bytesReceived += entry.bytesReceived;
+	}
+
+	delegate->setDuration(duration);
+
+	m_ui->summaryLabel->setText(tr("%n request(s), %1 from cache, %2 blocked, %3 received, finished in %4 ms", "", m_timeline.count()).arg(cachedRequests).arg(blockedRequests).arg(Utils::formatUnit(bytesReceived, false, 1)).arg(duration));
+	m_ui->requestsView->setModel(m_model);
+	m_ui->requestsView->setItemDelegateForColumn(6, delegate);
+	m_ui->requestsView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_ui->requestsView->header()->resizeSection(6, 200);
+
+	QPushButton *exportButton = m_ui->buttonBox->addButton(tr("Export HAR…"), QDialogButtonBox::ActionRole);
+	exportButton->setEnabled(!m_timeline.isEmpty());
+
+	connect(exportButton, SIGNAL(clicked()), this, SLOT(exportArchive()));
+}
+
+WebsiteInformationDialog::~WebsiteInformationDialog()
+{
+	delete m_ui;
+}
+
+void WebsiteInformationDialog::changeEvent(QEvent *event)
+{
+	QDialog::changeEvent(event);
+
+	switch (event->type())
+	{
+		case QEvent::LanguageChange:
+			m_ui->retranslateUi(this);
+
+			break;
+		default:
+			break;
+	}
+}
+
+void WebsiteInformationDialog::exportArchive()
+{
+	const QString path = TransfersManager::getSavePath((m_url.host().isEmpty() ? QLatin1String("page") : m_url.host()) + QLatin1String(".har"));
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	NetworkCache *cache = NetworkManagerFactory::getCache();
+	QList<HttpArchive::Entry> entries(m_timeline);
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		QIODevice *device = ((cache && !entries.at(i).isBlocked) ? cache->getEntryData(entries.at(i).url) : NULL);
+
+		if (device)
+		{
+			entries[i].body = device->readAll();
+
+			delete device;
+		}
+	}
+
+	if (!HttpArchive::save(path, entries, m_title))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Failed to save HTTP archive."), QMessageBox::Close);
+	}
+}
+
+}
@@ -34,6 +34,7 @@
 #include "../modules/windows/cookies/CookiesContentsWidget.h"
 #include "../modules/windows/configuration/ConfigurationContentsWidget.h"
 #include "../modules/windows/history/HistoryContentsWidget.h"
+#include "../modules/windows/network/NetworkStatisticsContentsWidget.h"
 #include "../modules/windows/transfers/TransfersContentsWidget.h"
 #include "../modules/windows/web/WebContentsWidget.h"
 
@@ -360,6 +361,10 @@ void Window::setUrl(const QUrl &url, bool typed)
 		{
 			newWidget = new HistoryContentsWidget(this);
 		}
+		else if (url.path() == QLatin1String("network"))
+		{
+			newWidget = new NetworkStatisticsContentsWidget(this);
+		}
 		else if (url.path() == QLatin1String("transfers"))
 		{
 			newWidget = new TransfersContentsWidget(this);